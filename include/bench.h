@@ -0,0 +1,12 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+// printf-style sink used for benchmark reports (pc_printf on target, stdout on host)
+typedef void (*bench_print_fn)(const char *fmt, ...);
+
+// Run the kernel micro-benchmarks and print one line per kernel.
+// Portable: the firmware calls this at boot when built with -D RTES_BENCH,
+// and tools/bench_host.cpp runs the same code on the PC.
+void run_benchmarks(bench_print_fn print);
+
+#endif // BENCH_H
@@ -11,6 +11,17 @@ void ble_service_update(std::uint8_t tremor_level,
                         std::uint8_t dyskinesia_level,
                         std::uint8_t fog_level);
 
+// Re-send the current values of all four characteristics (level refresh
+// timer), so a client that missed a notification catches up
+void ble_service_refresh();
+
+// Called once per window with the sampling health counters (saturated to 16 bits);
+// written to the 0xF254 characteristic when any of them changed
+void ble_service_update_health(std::uint16_t dropped_samples,
+                               std::uint16_t resampled_samples,
+                               std::uint16_t late_windows,
+                               std::uint16_t deadline_misses);
+
 // Call periodically from the main loop to drive BLE protocol stack event processing
 void ble_service_process();
 
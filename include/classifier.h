@@ -0,0 +1,33 @@
+#ifndef CLASSIFIER_H
+#define CLASSIFIER_H
+
+#include <cstdint>
+
+#include "window_features.h"
+
+// Tremor / dyskinesia levels decided by the classifier stage
+struct ClassifierOutput {
+    std::uint8_t tremor_level;      // 0..3
+    std::uint8_t dyskinesia_level;  // 0..3
+};
+
+// A classifier stage maps one window's feature vector to levels
+typedef ClassifierOutput (*classifier_fn)(const FeatureVector &features);
+
+// Original fixed threshold ladder on the band RMS features (config.h)
+ClassifierOutput classify_thresholds(const FeatureVector &features);
+
+// int8-quantised decision-tree ensemble (include/classifier_model.h).
+// Cost is bounded: at most CLF_NUM_HEADS * CLF_TREES_PER_HEAD * CLF_MAX_DEPTH
+// node visits, no allocation, all tables const.
+ClassifierOutput classify_model(const FeatureVector &features);
+
+// Tree node layout used by the generated model tables
+struct ClassifierNode {
+    std::int8_t   feature;    // FeatureIndex, or -1 for a leaf
+    std::int8_t   threshold;  // go left when q[feature] <= threshold
+    std::uint16_t left;       // child node index (leaf: index into leaf scores)
+    std::uint16_t right;      // child node index
+};
+
+#endif // CLASSIFIER_H
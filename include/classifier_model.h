@@ -0,0 +1,249 @@
+#ifndef CLASSIFIER_MODEL_H
+#define CLASSIFIER_MODEL_H
+
+// Generated by tools/export_classifier.py -- do not edit by hand.
+// Source: synthetic, 3000 windows labelled by the config.h threshold ladder (seed 1)
+// 2 heads x 4 trees, max depth 4, 130 nodes, 69 leaves
+// Training accuracy: tremor_level 99.87%, dysk_level 99.73%
+
+#include <cstddef>
+#include <cstdint>
+
+#include "classifier.h"
+
+static constexpr std::size_t CLF_NUM_HEADS      = 2;
+static constexpr std::size_t CLF_TREES_PER_HEAD = 4;
+static constexpr std::size_t CLF_MAX_DEPTH      = 4;
+static constexpr std::size_t CLF_NUM_NODES      = 130;
+static constexpr std::size_t CLF_NUM_LEAVES     = 69;
+
+// q = clamp(floor(x * inv_scale + 0.5) + zero_point, -128, 127), FeatureIndex order
+static const float CLF_FEATURE_INV_SCALE[NUM_FEATURES] = {
+    6.425554810e+02f,  // tremor_rms
+    6.400902710e+02f,  // dysk_rms
+    8.502174683e+02f,  // gait_rms
+    1.020033836e+01f,  // dominant_hz
+    2.550336456e+02f,  // spectral_entropy
+    1.020096588e+02f,  // cadence_hz
+    2.550741455e+03f,  // mag_variance
+};
+
+static const std::int8_t CLF_FEATURE_ZERO_POINT[NUM_FEATURES] = {
+    -128, -128, -128, -128, -128, -128, -128
+};
+
+// { feature, threshold, left, right }: go left when q[feature] <= threshold.
+// Leaves have feature = -1 and left = index into CLF_LEAF_SCORES.
+static const ClassifierNode CLF_NODES[CLF_NUM_NODES] = {
+    { 0, -109, 1, 8 },
+    { 0, -110, 2, 3 },
+    { -1, 0, 0, 0 },
+    { 4, -56, 4, 5 },
+    { -1, 0, 1, 0 },
+    { 4, 73, 6, 7 },
+    { -1, 0, 2, 0 },
+    { -1, 0, 3, 0 },
+    { 0, -52, 9, 14 },
+    { 0, -83, 10, 13 },
+    { 0, -84, 11, 12 },
+    { -1, 0, 4, 0 },
+    { -1, 0, 5, 0 },
+    { -1, 0, 6, 0 },
+    { 0, -51, 15, 16 },
+    { -1, 0, 7, 0 },
+    { -1, 0, 8, 0 },
+    { 0, -109, 18, 25 },
+    { 0, -110, 19, 20 },
+    { -1, 0, 9, 0 },
+    { 3, -13, 21, 22 },
+    { -1, 0, 10, 0 },
+    { 3, 26, 23, 24 },
+    { -1, 0, 11, 0 },
+    { -1, 0, 12, 0 },
+    { 0, -51, 26, 33 },
+    { 0, -83, 27, 30 },
+    { 0, -84, 28, 29 },
+    { -1, 0, 13, 0 },
+    { -1, 0, 14, 0 },
+    { 0, -52, 31, 32 },
+    { -1, 0, 15, 0 },
+    { -1, 0, 16, 0 },
+    { -1, 0, 17, 0 },
+    { 0, -109, 35, 42 },
+    { 0, -110, 36, 37 },
+    { -1, 0, 18, 0 },
+    { 2, -107, 38, 39 },
+    { -1, 0, 19, 0 },
+    { 2, -37, 40, 41 },
+    { -1, 0, 20, 0 },
+    { -1, 0, 21, 0 },
+    { 0, -52, 43, 48 },
+    { 0, -83, 44, 47 },
+    { 3, 121, 45, 46 },
+    { -1, 0, 22, 0 },
+    { -1, 0, 23, 0 },
+    { -1, 0, 24, 0 },
+    { 0, -51, 49, 52 },
+    { 5, -128, 50, 51 },
+    { -1, 0, 25, 0 },
+    { -1, 0, 26, 0 },
+    { -1, 0, 27, 0 },
+    { 0, -109, 54, 61 },
+    { 0, -110, 55, 56 },
+    { -1, 0, 28, 0 },
+    { 6, -21, 57, 60 },
+    { 6, -48, 58, 59 },
+    { -1, 0, 29, 0 },
+    { -1, 0, 30, 0 },
+    { -1, 0, 31, 0 },
+    { 0, -52, 62, 65 },
+    { 0, -83, 63, 64 },
+    { -1, 0, 32, 0 },
+    { -1, 0, 33, 0 },
+    { 0, -51, 66, 69 },
+    { 1, -119, 67, 68 },
+    { -1, 0, 34, 0 },
+    { -1, 0, 35, 0 },
+    { -1, 0, 36, 0 },
+    { 1, -109, 71, 80 },
+    { 1, -110, 72, 73 },
+    { -1, 0, 37, 0 },
+    { 4, -3, 74, 77 },
+    { 3, 30, 75, 76 },
+    { -1, 0, 38, 0 },
+    { -1, 0, 39, 0 },
+    { 3, -32, 78, 79 },
+    { -1, 0, 40, 0 },
+    { -1, 0, 41, 0 },
+    { 1, -51, 81, 86 },
+    { 1, -84, 82, 83 },
+    { -1, 0, 42, 0 },
+    { 1, -52, 84, 85 },
+    { -1, 0, 43, 0 },
+    { -1, 0, 44, 0 },
+    { -1, 0, 45, 0 },
+    { 1, -109, 88, 95 },
+    { 1, -110, 89, 90 },
+    { -1, 0, 46, 0 },
+    { 3, -32, 91, 92 },
+    { -1, 0, 47, 0 },
+    { 4, -3, 93, 94 },
+    { -1, 0, 48, 0 },
+    { -1, 0, 49, 0 },
+    { 1, -51, 96, 101 },
+    { 1, -84, 97, 98 },
+    { -1, 0, 50, 0 },
+    { 1, -52, 99, 100 },
+    { -1, 0, 51, 0 },
+    { -1, 0, 52, 0 },
+    { -1, 0, 53, 0 },
+    { 1, -109, 103, 110 },
+    { 1, -110, 104, 105 },
+    { -1, 0, 54, 0 },
+    { 3, 74, 106, 109 },
+    { 2, -73, 107, 108 },
+    { -1, 0, 55, 0 },
+    { -1, 0, 56, 0 },
+    { -1, 0, 57, 0 },
+    { 1, -51, 111, 116 },
+    { 1, -84, 112, 113 },
+    { -1, 0, 58, 0 },
+    { 1, -83, 114, 115 },
+    { -1, 0, 59, 0 },
+    { -1, 0, 60, 0 },
+    { -1, 0, 61, 0 },
+    { 1, -109, 118, 123 },
+    { 1, -110, 119, 120 },
+    { -1, 0, 62, 0 },
+    { 6, 70, 121, 122 },
+    { -1, 0, 63, 0 },
+    { -1, 0, 64, 0 },
+    { 1, -51, 124, 129 },
+    { 1, -84, 125, 126 },
+    { -1, 0, 65, 0 },
+    { 1, -52, 127, 128 },
+    { -1, 0, 66, 0 },
+    { -1, 0, 67, 0 },
+    { -1, 0, 68, 0 },
+};
+
+// Per-leaf class scores (levels 0..3), summed over the trees of a head
+static const std::int8_t CLF_LEAF_SCORES[CLF_NUM_LEAVES][4] = {
+    { 127, 0, 0, 0 },
+    { 64, 64, 0, 0 },
+    { 127, 0, 0, 0 },
+    { 91, 36, 0, 0 },
+    { 0, 127, 0, 0 },
+    { 0, 102, 25, 0 },
+    { 0, 0, 127, 0 },
+    { 0, 0, 54, 73 },
+    { 0, 0, 0, 127 },
+    { 127, 0, 0, 0 },
+    { 127, 0, 0, 0 },
+    { 25, 102, 0, 0 },
+    { 127, 0, 0, 0 },
+    { 0, 127, 0, 0 },
+    { 0, 102, 25, 0 },
+    { 0, 0, 127, 0 },
+    { 0, 0, 85, 42 },
+    { 0, 0, 0, 127 },
+    { 127, 0, 0, 0 },
+    { 127, 0, 0, 0 },
+    { 25, 102, 0, 0 },
+    { 127, 0, 0, 0 },
+    { 0, 127, 0, 0 },
+    { 0, 102, 25, 0 },
+    { 0, 0, 127, 0 },
+    { 0, 0, 127, 0 },
+    { 0, 0, 0, 127 },
+    { 0, 0, 0, 127 },
+    { 127, 0, 0, 0 },
+    { 127, 0, 0, 0 },
+    { 48, 79, 0, 0 },
+    { 127, 0, 0, 0 },
+    { 0, 127, 0, 0 },
+    { 0, 0, 127, 0 },
+    { 0, 0, 32, 95 },
+    { 0, 0, 64, 64 },
+    { 0, 0, 0, 127 },
+    { 127, 0, 0, 0 },
+    { 127, 0, 0, 0 },
+    { 95, 32, 0, 0 },
+    { 109, 18, 0, 0 },
+    { 28, 99, 0, 0 },
+    { 0, 127, 0, 0 },
+    { 0, 1, 126, 0 },
+    { 0, 0, 73, 54 },
+    { 0, 0, 0, 127 },
+    { 127, 0, 0, 0 },
+    { 127, 0, 0, 0 },
+    { 98, 29, 0, 0 },
+    { 27, 100, 0, 0 },
+    { 0, 127, 0, 0 },
+    { 0, 0, 127, 0 },
+    { 0, 0, 76, 51 },
+    { 0, 0, 0, 127 },
+    { 127, 0, 0, 0 },
+    { 121, 6, 0, 0 },
+    { 64, 64, 0, 0 },
+    { 0, 127, 0, 0 },
+    { 0, 127, 0, 0 },
+    { 0, 20, 107, 0 },
+    { 0, 0, 127, 0 },
+    { 0, 0, 0, 127 },
+    { 127, 0, 0, 0 },
+    { 127, 0, 0, 0 },
+    { 73, 54, 0, 0 },
+    { 0, 127, 0, 0 },
+    { 0, 1, 126, 0 },
+    { 0, 0, 73, 54 },
+    { 0, 0, 0, 127 },
+};
+
+// Root node of every tree, per head (tremor, dyskinesia)
+static const std::uint16_t CLF_TREE_ROOT[CLF_NUM_HEADS][CLF_TREES_PER_HEAD] = {
+    { 0, 17, 34, 53 },
+    { 70, 87, 102, 117 },
+};
+
+#endif // CLASSIFIER_MODEL_H
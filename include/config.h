@@ -2,6 +2,7 @@
 #define CONFIG_H
 
 #include <cstddef>
+#include <cstdint>
 
 // Sampling frequency and window length (fixed by the challenge)
 static constexpr float SAMPLE_FREQUENCY_HZ = 52.0f;   // 52 Hz ODR of LSM6DSL
@@ -18,6 +19,61 @@ static constexpr std::size_t FFT_LENGTH = 256;
 // LSM6DSL sensitivity at ±2 g: 0.061 mg/LSB ≈ 0.000061 g/LSB
 static constexpr float ACC_G_PER_LSB = 0.000061f;
 
+// ------------------------------------------------------------
+// Oversampled acquisition (FIFO + polyphase decimation)
+// ------------------------------------------------------------
+//
+// The IMU runs at SAMPLE_FREQUENCY_HZ * ACQ_OVERSAMPLE_FACTOR and buffers
+// samples in its FIFO. A fixed-point polyphase FIR low-pass then decimates
+// back to SAMPLE_FREQUENCY_HZ, so content above 26 Hz no longer aliases
+// into the 3–7 Hz bands.
+//   1 -> legacy mode: direct register reads at 52 Hz, no FIFO / FIR
+//   4 -> 208 Hz ODR
+//   8 -> 416 Hz ODR
+static constexpr std::size_t ACQ_OVERSAMPLE_FACTOR = 4;
+
+static constexpr float ACQ_ODR_HZ =
+    SAMPLE_FREQUENCY_HZ * static_cast<float>(ACQ_OVERSAMPLE_FACTOR);
+
+// FIR taps per polyphase branch; total taps = factor * taps per phase.
+// 8 taps/phase gives a 32-tap filter at 208 Hz and 64 taps at 416 Hz.
+static constexpr std::size_t DECIM_TAPS_PER_PHASE = 8;
+
+// FIR cutoff. Everything of interest (steps, 3–7 Hz bands) sits well
+// below this, while the transition band ends before 52 - 7 = 45 Hz.
+static constexpr float DECIM_CUTOFF_HZ = 20.0f;
+
+// Number of XYZ sets drained from the FIFO per poll
+// (16 sets @ 208 Hz ≈ 77 ms between polls).
+static constexpr std::size_t ACQ_FIFO_BATCH_SETS = 16;
+
+// LSM6DSL FIFO: 4 KB = 2048 words = 682 accelerometer XYZ sets
+static constexpr std::size_t ACQ_FIFO_CAPACITY_SETS = 682;
+
+// ------------------------------------------------------------
+// Sample timing / runtime health
+// ------------------------------------------------------------
+
+// Nominal analysis-rate sample period: 1 / 52 Hz ≈ 19230.8 µs
+static constexpr float SAMPLE_PERIOD_US = 1000000.0f / SAMPLE_FREQUENCY_HZ;
+
+// A sample whose sensor timestamp is further than this from its slot on
+// the uniform grid is re-sampled (linear interpolation) instead of being
+// passed through as-is.
+static constexpr float TIMING_JITTER_BOUND_US = 2500.0f;
+
+// A window closing more than this after WINDOW_SECONDS since the previous
+// one is counted as late.
+static constexpr float LATE_WINDOW_TOLERANCE_US = 100000.0f;
+
+// Processing deadline for one window. Legacy mode has to finish before the
+// next sample is due; in FIFO mode the FIFO absorbs the work as long as it
+// does not fill up.
+static constexpr float PROCESS_DEADLINE_US =
+    (ACQ_OVERSAMPLE_FACTOR > 1)
+        ? 1000000.0f * static_cast<float>(ACQ_FIFO_CAPACITY_SETS - 2 * ACQ_FIFO_BATCH_SETS) / ACQ_ODR_HZ
+        : SAMPLE_PERIOD_US;
+
 // ------------------------------------------------------------
 // Step detection (waist-worn, based on acceleration magnitude)
 // ------------------------------------------------------------
@@ -39,6 +95,10 @@ static constexpr float TREMOR_F_MAX_HZ = 5.0f;
 static constexpr float DYSK_F_MIN_HZ   = 5.0f;
 static constexpr float DYSK_F_MAX_HZ   = 7.0f;
 
+// Gait band, only used as a classifier feature
+static constexpr float GAIT_F_MIN_HZ   = 0.5f;
+static constexpr float GAIT_F_MAX_HZ   = 3.0f;
+
 // ------------------------------------------------------------
 // Tremor / dyskinesia intensity thresholds (band RMS, in g)
 // ------------------------------------------------------------
@@ -57,6 +117,22 @@ static constexpr float DYSK_LEVEL1_RMS_G   = 0.03f;
 static constexpr float DYSK_LEVEL2_RMS_G   = 0.07f;
 static constexpr float DYSK_LEVEL3_RMS_G   = 0.12f;
 
+// ------------------------------------------------------------
+// Classifier stage
+// ------------------------------------------------------------
+
+// true  -> int8 decision-tree ensemble from include/classifier_model.h
+//          (generated by tools/export_classifier.py)
+// false -> fixed threshold ladder above
+// The committed model is trained on synthetic windows labelled by the ladder
+// itself; keep the ladder until a model exported from labelled [FEAT]
+// recordings is in place.
+static constexpr bool CLASSIFIER_USE_MODEL = false;
+
+// Upper bound on node visits per window (heads * trees * depth), checked
+// against the generated model at compile time
+static constexpr std::size_t CLASSIFIER_MAX_NODE_VISITS = 64;
+
 // ------------------------------------------------------------
 // FOG decision
 // ------------------------------------------------------------
@@ -65,4 +141,32 @@ static constexpr float DYSK_LEVEL3_RMS_G   = 0.12f;
 // considered a candidate FOG event.
 static constexpr std::size_t FOG_MIN_WALKING_WINDOWS = 2;
 
+// ------------------------------------------------------------
+// Window history and publishing
+// ------------------------------------------------------------
+
+// Feature vectors kept for trends: 20 windows = 1 min
+static constexpr std::size_t HISTORY_WINDOWS = 20;
+
+// EMA weight of the newest window (~ last 4 windows)
+static constexpr float HISTORY_EMA_ALPHA = 0.25f;
+
+// Trend line ([TREND] + Teleplot) every n windows
+static constexpr std::size_t TREND_REPORT_WINDOWS = 10;
+
+// Level hysteresis: a level changes at once when the band RMS EMA is this
+// fraction past the threshold between the two levels, otherwise only after
+// the last LEVEL_CONFIRM_WINDOWS windows in the history were all past it
+static constexpr float        LEVEL_HYSTERESIS_FRAC = 0.15f;
+static constexpr std::uint8_t LEVEL_CONFIRM_WINDOWS = 2;
+static_assert(LEVEL_CONFIRM_WINDOWS >= 1 && LEVEL_CONFIRM_WINDOWS <= HISTORY_WINDOWS,
+              "the confirmation windows must fit in the history ring");
+
+// Minimum windows between two level notifications (FOG is never held back)
+static constexpr std::uint32_t PUBLISH_MIN_INTERVAL_WINDOWS = 3;
+
+// Unchanged levels are re-sent after this many windows without a
+// notification (1 min), so a client that missed one catches up
+static constexpr std::uint32_t PUBLISH_REFRESH_WINDOWS = 20;
+
 #endif // CONFIG_H
@@ -0,0 +1,40 @@
+#ifndef DECIMATOR_H
+#define DECIMATOR_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "config.h"
+
+// Fixed-point polyphase FIR decimator (decimation factor = ACQ_OVERSAMPLE_FACTOR).
+// Input and output are raw LSM6DSL counts (int16); coefficients are Q15 and
+// generated at compile time (windowed sinc, cutoff DECIM_CUTOFF_HZ).
+//
+// Each branch keeps its own delay line stored twice back-to-back, so the
+// dot product always runs over a contiguous window and never wraps.
+// Cost is DECIM_TAPS_PER_PHASE MACs per input sample, spread evenly.
+static constexpr std::size_t DECIM_FACTOR = ACQ_OVERSAMPLE_FACTOR;
+static constexpr std::size_t DECIM_TAPS   = DECIM_FACTOR * DECIM_TAPS_PER_PHASE;
+
+// One state per channel (axis)
+struct DecimatorState {
+    std::int16_t delay[DECIM_FACTOR][2 * DECIM_TAPS_PER_PHASE];
+    std::size_t  pos;    // newest slot in every branch delay line
+    std::size_t  phase;  // input index within the current output block
+    std::int32_t acc;    // partial sum of the output being built
+};
+
+// Clear history and restart the phase counter
+void decimator_reset(DecimatorState &st);
+
+// Feed n input samples (read with in_stride, e.g. 3 for interleaved XYZ).
+// Decimated samples are written to out (with out_stride).
+// Returns the number of output samples produced (at most n / DECIM_FACTOR + 1).
+std::size_t decimator_process(DecimatorState &st,
+                              const std::int16_t *in,
+                              std::size_t n,
+                              std::size_t in_stride,
+                              std::int16_t *out,
+                              std::size_t out_stride);
+
+#endif // DECIMATOR_H
@@ -5,6 +5,8 @@
 #include <cstddef>
 
 #include "config.h"
+#include "classifier.h"
+#include "window_features.h"
 
 // Structure used to pass detection results between main and BLE layers
 struct DetectionResult {
@@ -17,9 +19,36 @@ struct DetectionResult {
     float step_rate_hz;             // estimated step rate in the current window
 };
 
-// Detect tremor / dyskinesia / FOG from a single-sided magnitude spectrum and step count
-DetectionResult detect_conditions(const float *spectrum_mag,
-                                    std::size_t spectrum_bins,
-                                    std::uint16_t step_count);
+// Cross-window FOG state (a sudden stop after a period of walking).
+// One per wearer; the firmware uses a single internal instance.
+struct FogState {
+    std::size_t consecutive_walking_windows;
+};
+
+void fog_state_reset(FogState &fog);
+
+// Detect tremor / dyskinesia / FOG from one window's feature vector
+// (see extract_features). Levels come from the active classifier stage,
+// FOG from the step rate history kept in fog.
+DetectionResult detect_conditions(const FeatureVector &features, FogState &fog);
+
+// Same, using the detector's internal FogState (single wearer)
+DetectionResult detect_conditions(const FeatureVector &features);
+
+// Map a band RMS value to a level 0..3 using thresholds l1 < l2 < l3
+std::uint8_t classify_level(float rms_g, float l1, float l2, float l3);
+
+// Band RMS (tremor 3–5 Hz, dyskinesia 5–7 Hz) from a single-sided magnitude spectrum.
+// Reference: tests the frequency of every bin.
+void integrate_bands_reference(const float *spectrum_mag,
+                               std::size_t spectrum_bins,
+                               float &tremor_rms_g,
+                               float &dysk_rms_g);
+
+// Same result using bin ranges precomputed on the first call (used by detect_conditions)
+void integrate_bands(const float *spectrum_mag,
+                     std::size_t spectrum_bins,
+                     float &tremor_rms_g,
+                     float &dysk_rms_g);
 
 #endif // DETECTOR_H
@@ -26,4 +26,13 @@ void compute_dft_magnitude(const float *time_data,
                            float *mag_out,
                             std::size_t fft_length);
 
+// Radix-2 FFT producing the same single-sided magnitude spectrum (same scaling
+// as compute_dft_magnitude). fft_length must be a power of two <= FFT_LENGTH
+// and >= time_samples; anything else falls back to compute_dft_magnitude.
+// Twiddle factors are built on the first call. Not reentrant (static work buffers).
+void compute_fft_magnitude(const float *time_data,
+                           std::size_t time_samples,
+                           float *mag_out,
+                           std::size_t fft_length);
+
 #endif // FFT_UTILS_H
@@ -0,0 +1,75 @@
+#ifndef I2C_TXN_H
+#define I2C_TXN_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Non-blocking I²C transaction queue for register access.
+//
+// Register reads / writes are queued and run back-to-back on the bus: when
+// a transfer completes (an interrupt on the board) the next one is started
+// right away, so the CPU only spends time on a transaction when it is
+// queued, started or finished, never while the bytes are on the wire.
+// Completion callbacks run later, in order, from i2c_txn_dispatch() in
+// thread context, so they may queue follow-up transactions (e.g. a FIFO
+// status read followed by the data burst).
+//
+// The bus itself is a backend function: I2C::transfer on the board
+// (lsm6dsl_driver.cpp), a simulated bus on the host (tools/i2c_txn_host.cpp).
+
+// Queue slots (power of two)
+static constexpr std::size_t I2C_TXN_QUEUE_LEN = 8;
+
+// Backend: start one transfer to the 8-bit address addr8. Write tx_len bytes,
+// then, if rx_len > 0, read rx_len bytes after a repeated start. Must call
+// i2c_txn_complete() exactly once when the transfer ends; it may do so
+// before returning (synchronous backends). Returns false if the transfer
+// could not be started (i2c_txn_complete() must then not be called).
+typedef bool (*i2c_start_fn)(std::uint8_t addr8,
+                             const std::uint8_t *tx, std::size_t tx_len,
+                             std::uint8_t *rx, std::size_t rx_len);
+
+// Optional: run fn later in thread context. Used when the backend cannot be
+// restarted from its completion interrupt (mbed's I2C::transfer takes a
+// mutex); without it the next transfer is started inside i2c_txn_complete().
+// Returns false if fn could not be scheduled (i2c_txn_dispatch() then
+// starts the next transfer).
+typedef bool (*i2c_defer_fn)(void (*fn)());
+
+// Completion callback, run from i2c_txn_dispatch()
+typedef void (*i2c_txn_done_fn)(bool ok, void *user);
+
+struct I2CTxnStats {
+    std::uint32_t queued;     // transactions accepted
+    std::uint32_t rejected;   // queue full
+    std::uint32_t failed;     // NACK / bus error / could not start
+    std::uint32_t max_depth;  // most transactions queued or undispatched at once
+};
+
+// Reset the queue and select the bus backend (defer may be nullptr).
+// No transaction may be in flight.
+void i2c_txn_init(i2c_start_fn start, i2c_defer_fn defer);
+
+// Queue a single-register write.
+// Return: false if the queue is full (nothing was queued)
+bool i2c_txn_write_reg(std::uint8_t addr8, std::uint8_t reg, std::uint8_t value,
+                       i2c_txn_done_fn done, void *user);
+
+// Queue a burst read of len registers starting at reg into buf; buf must
+// stay valid until the callback has run
+bool i2c_txn_read_regs(std::uint8_t addr8, std::uint8_t reg, std::uint8_t *buf, std::size_t len,
+                       i2c_txn_done_fn done, void *user);
+
+// Called by the backend when the transfer it started has ended (ISR-safe)
+void i2c_txn_complete(bool ok);
+
+// Run the callbacks of finished transactions, oldest first.
+// Returns the number of callbacks run.
+std::size_t i2c_txn_dispatch();
+
+// True while any transaction is queued, on the bus or not yet dispatched
+bool i2c_txn_pending();
+
+const I2CTxnStats &i2c_txn_stats();
+
+#endif // I2C_TXN_H
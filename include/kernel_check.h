@@ -0,0 +1,21 @@
+#ifndef KERNEL_CHECK_H
+#define KERNEL_CHECK_H
+
+#include "bench.h"
+
+// Differential check of the optimised kernel variants against the reference
+// kernels (compute_dft_magnitude, integrate_bands_reference) on a fixed set
+// of golden signals plus seeded random ones.
+//
+// For every variant it prints the worst absolute / relative error per
+// spectrum bin and per band RMS, whether the final tremor / dyskinesia
+// levels agree, and the time per call of reference and variant. The window
+// history's running statistics are checked against a recompute over the ring,
+// and the publish filters against scripted level / gate sequences.
+// Returns false if any variant exceeds its declared error budget.
+//
+// Portable like run_benchmarks(): the firmware runs it at boot when built
+// with -D RTES_KERNEL_CHECK, tools/kernel_check_host.cpp runs it on the PC.
+bool run_kernel_check(bench_print_fn print);
+
+#endif // KERNEL_CHECK_H
@@ -4,10 +4,43 @@
 #include "mbed.h"
 
 // Initialize LSM6DSL: set ODR=52 Hz, accel range ±2g, gyro 52 Hz, etc.
+// With ACQ_OVERSAMPLE_FACTOR > 1 the accelerometer runs at ACQ_ODR_HZ and
+// streams into the FIFO (continuous mode) instead.
 bool lsm6dsl_init();
 
 // Read one accelerometer sample (units: g)
 // Return: true = success, false = communication failure
 bool lsm6dsl_read_accel(float &ax_g, float &ay_g, float &az_g);
 
+// Read the sensor timestamp counter, unwrapped to a monotonic µs time base
+// (32-bit, wraps after ~71 min). Must be called at least every ~419 s so
+// no 24-bit counter wrap is missed.
+// Return: true = success, false = communication failure
+bool lsm6dsl_read_timestamp(uint32_t &ts_us);
+
+// Read one accelerometer sample and the sensor timestamp (µs) for it. The
+// timestamp is read in a second transaction right after the data; the bus
+// time of one read is subtracted so it refers to when the data was read out.
+// What remains is a bias of up to one ODR period (the output register holds
+// the latest conversion, not one taken at read time) plus the software gap
+// between the two transactions; neither adds jitter between samples.
+// Return: true = success, false = communication failure
+bool lsm6dsl_read_accel_timestamped(float &ax_g, float &ay_g, float &az_g, uint32_t &ts_us);
+
+// Non-blocking FIFO poll (oversampled mode): queue the timestamp, FIFO status
+// and data reads on the I2C transaction layer and return at once; the CPU is
+// free while the bytes are transferred. Up to max_sets complete XYZ sets are
+// drained into xyz_raw as interleaved raw counts (x0, y0, z0, x1, ...), so it
+// must hold 3 * max_sets values and stay untouched until the poll is done.
+// Return: false if a poll is still running or the queue is full
+bool lsm6dsl_fifo_poll_start(int16_t *xyz_raw, size_t max_sets);
+
+// Call from the main loop (runs pending transaction callbacks). Returns true
+// once the poll has finished. ts_us is the unwrapped sensor timestamp (as for
+// lsm6dsl_read_timestamp), sets_read the sets written to xyz_raw (0 when the
+// FIFO held no full set) and available_sets the complete sets waiting when
+// the status was read. ok = false means some transfer failed (sets_read is
+// then 0).
+bool lsm6dsl_fifo_poll_done(bool &ok, uint32_t &ts_us, size_t &sets_read, size_t &available_sets);
+
 #endif // LSM6DSL_DRIVER_H
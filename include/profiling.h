@@ -0,0 +1,61 @@
+#ifndef PROFILING_H
+#define PROFILING_H
+
+#include <cstdint>
+
+// Minimal timing helpers shared by the on-target and host benchmarks.
+// On the MCU this is the Cortex-M DWT cycle counter (1 tick = 1 core cycle);
+// on the host it is std::chrono::steady_clock in nanoseconds.
+// Tick values wrap at 32 bits, so only time spans shorter than one wrap
+// (~53 s @ 80 MHz, ~4.2 s on host) are meaningful.
+
+#if defined(__MBED__)
+
+#include "mbed.h"
+
+inline void prof_init()
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+inline std::uint32_t prof_now()
+{
+    return DWT->CYCCNT;
+}
+
+inline std::uint32_t prof_tick_hz()
+{
+    return SystemCoreClock;
+}
+
+#else
+
+#include <chrono>
+
+inline void prof_init()
+{
+}
+
+inline std::uint32_t prof_now()
+{
+    using namespace std::chrono;
+    return static_cast<std::uint32_t>(
+        duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+}
+
+inline std::uint32_t prof_tick_hz()
+{
+    return 1000000000u;
+}
+
+#endif
+
+// Convert a tick delta to nanoseconds
+inline float prof_ticks_to_ns(std::uint32_t ticks)
+{
+    return static_cast<float>(ticks) * (1.0e9f / static_cast<float>(prof_tick_hz()));
+}
+
+#endif // PROFILING_H
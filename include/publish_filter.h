@@ -0,0 +1,67 @@
+#ifndef PUBLISH_FILTER_H
+#define PUBLISH_FILTER_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "config.h"
+#include "window_history.h"
+
+// Filters between the per-window detection result and what is published
+//   (LEDs, BLE notifications and the [BLE] update line), both driven by the
+//   window history (push the window before filtering it):
+//   - level hysteresis: a tremor / dyskinesia level only changes once the
+//     band RMS EMA is clearly past the threshold between the two levels, or
+//     the last LEVEL_CONFIRM_WINDOWS windows in the ring were all past it, so
+//     a value sitting on a threshold does not toggle the level every window;
+//   - publish gate: level changes are sent at most once per
+//     PUBLISH_MIN_INTERVAL_WINDOWS windows of the history; a change that
+//     arrives early is held and sent as soon as the interval has passed. FOG
+//     changes bypass the interval. Unchanged levels are re-sent every
+//     PUBLISH_REFRESH_WINDOWS windows.
+
+struct LevelHysteresis {
+    std::uint8_t level;          // filtered level
+};
+
+void level_hysteresis_reset(LevelHysteresis &h);
+
+// Filter one window's raw level for the band feature it was derived from
+// (FEAT_TREMOR_RMS_G / FEAT_DYSK_RMS_G, already pushed to hist); l1 < l2 < l3
+// are the thresholds of that band. Returns the filtered level.
+std::uint8_t level_hysteresis_update(LevelHysteresis &h,
+                                     std::uint8_t raw_level,
+                                     const WindowHistory &hist,
+                                     FeatureIndex band,
+                                     float l1, float l2, float l3);
+
+struct PublishedLevels {
+    std::uint8_t tremor_level;
+    std::uint8_t dyskinesia_level;
+    std::uint8_t fog_level;
+};
+
+enum PublishAction : std::uint8_t {
+    PUBLISH_NONE = 0,
+    PUBLISH_CHANGE,              // levels changed: send them
+    PUBLISH_REFRESH              // unchanged, refresh timer expired: re-send
+};
+
+struct PublishGate {
+    PublishedLevels published;   // last levels sent
+    bool          pending;       // a change is being held back
+    std::uint32_t last_window;   // WindowHistory::pushed at the last publish
+    std::uint32_t sent;          // publishes (changes)
+    std::uint32_t refreshed;     // publishes (refresh timer)
+    std::uint32_t held;          // windows in which a change was held back
+};
+
+void publish_gate_reset(PublishGate &g);
+
+// Called once per window, after history_push(), with the filtered levels.
+// Returns what to publish now (and records the levels as published).
+PublishAction publish_gate_update(PublishGate &g,
+                                  const WindowHistory &hist,
+                                  const PublishedLevels &levels);
+
+#endif // PUBLISH_FILTER_H
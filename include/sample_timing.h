@@ -0,0 +1,87 @@
+#ifndef SAMPLE_TIMING_H
+#define SAMPLE_TIMING_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "config.h"
+
+// Runtime counters describing how regular the sampling actually is.
+// Counters are cumulative since boot (or timing_reset()).
+struct TimingStats {
+    std::uint32_t dropped_samples;   // failed reads + sets lost to FIFO overrun
+    std::uint32_t filled_samples;    // grid slots re-created by interpolation
+    std::uint32_t resampled_samples; // samples moved onto the grid (jitter > bound)
+    std::uint32_t late_windows;      // windows closed later than expected
+    std::uint32_t deadline_misses;   // window processing exceeded PROCESS_DEADLINE_US
+    std::uint32_t max_jitter_us;     // worst |timestamp - nearest grid slot| (missed reads excluded)
+    std::uint32_t last_process_us;   // processing time of the last window
+    std::uint32_t max_process_us;    // worst window processing time
+    std::uint32_t max_sample_ticks;  // worst per-sample accumulator update (profiling ticks)
+    std::uint32_t last_close_ticks;  // window close: finalise + features + classifier
+    std::uint32_t max_close_ticks;
+};
+
+// One analysis-rate sample (units: g)
+struct TimedSample {
+    float ax;
+    float ay;
+    float az;
+};
+
+// Clear all counters and the resampler / FIFO tracking state
+void timing_reset();
+
+const TimingStats &timing_stats();
+
+// ------------------------------------------------------------
+// Legacy (direct read) mode
+// ------------------------------------------------------------
+
+// A register read failed; the sample is counted as dropped and its grid
+// slot is re-created from its neighbours when the next sample arrives.
+void timing_note_read_failure();
+
+// Place one sample, stamped with the sensor timestamp (µs), on the uniform
+// SAMPLE_FREQUENCY_HZ grid. Within TIMING_JITTER_BOUND_US it passes through
+// unchanged; otherwise the grid slots up to ts_us are linearly interpolated.
+// A gap longer than max_out slots is not bridged: the open slots are counted
+// as dropped and the grid restarts on this sample.
+// Returns the number of samples written to out (0 .. max_out).
+std::size_t timing_push_sample(std::uint32_t ts_us,
+                               float ax, float ay, float az,
+                               TimedSample *out,
+                               std::size_t max_out);
+
+// ------------------------------------------------------------
+// FIFO (oversampled) mode
+// ------------------------------------------------------------
+
+// Call once per FIFO poll with the sensor timestamp (µs), the number of sets
+// waiting in the FIFO at that time and the number drained by the previous
+// poll (which may exceed the level it saw, if it kept reading while the
+// sensor produced more). Returns how many sets the FIFO must have
+// overwritten since then; they are also added to dropped_samples (in
+// analysis-rate samples).
+std::size_t timing_check_fifo(std::uint32_t ts_us,
+                              std::size_t available_sets,
+                              std::size_t drained_last_poll);
+
+// Note sets re-created by interpolation in front of the decimator
+void timing_note_fifo_fill(std::size_t sets);
+
+// ------------------------------------------------------------
+// Window bookkeeping
+// ------------------------------------------------------------
+
+// Cost of one per-sample accumulator update, in profiling ticks (profiling.h)
+void timing_note_sample_cost(std::uint32_t ticks);
+
+// Cost of closing a window (finalisation + features + classifier), in ticks
+void timing_note_window_close(std::uint32_t ticks);
+
+// A window was processed: close_us = MCU time the window closed,
+// process_us = time spent in the pipeline for it
+void timing_window_done(std::uint32_t close_us, std::uint32_t process_us);
+
+#endif // SAMPLE_TIMING_H
@@ -0,0 +1,58 @@
+#ifndef WINDOW_ACCUMULATOR_H
+#define WINDOW_ACCUMULATOR_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "config.h"
+
+// Streaming per-window accumulator. Every sample updates, in one pass:
+//   - the acceleration magnitude,
+//   - running mean / variance of the magnitude (Welford),
+//   - the step detector state (same rule as estimate_step_count),
+//   - the DFT partial sums of bins 0 .. FFT_LENGTH/2-1 (zero-padded
+//     FFT_LENGTH-point DFT, same scaling as compute_dft_magnitude).
+// Closing the window then only costs one sqrt per bin, independent of the
+// window length, instead of three full passes over the buffered samples.
+
+static constexpr std::size_t ACC_SPECTRUM_BINS = FFT_LENGTH / 2;
+
+struct WindowAccumulator {
+    std::size_t n;                 // samples pushed in this window
+
+    float mag_mean;                // Welford running mean of |a|
+    float mag_m2;                  // Welford sum of squared deviations
+
+    std::uint16_t steps;           // step detector state
+    bool          step_seen;
+    std::size_t   last_step_index;
+
+    float re[ACC_SPECTRUM_BINS];   // DFT partial sums
+    float im[ACC_SPECTRUM_BINS];
+};
+
+// Start a new window
+void window_acc_reset(WindowAccumulator &acc);
+
+// Add one magnitude sample (g); n must stay below FFT_LENGTH
+void window_acc_push_mag(WindowAccumulator &acc, float mag);
+
+// Add one 3-axis sample (g)
+void window_acc_push(WindowAccumulator &acc, float ax, float ay, float az);
+
+// Window results: single-sided magnitude spectrum (ACC_SPECTRUM_BINS values),
+// step count and magnitude variance
+void window_acc_finish(const WindowAccumulator &acc,
+                       float *spectrum_out,
+                       std::uint16_t &step_count,
+                       float &mag_variance);
+
+// compute_dft_magnitude-compatible wrapper (streams time_data through a
+// private accumulator); fft_length other than FFT_LENGTH, or more samples
+// than FFT_LENGTH, falls back to compute_dft_magnitude. Not reentrant.
+void compute_streaming_dft_magnitude(const float *time_data,
+                                     std::size_t time_samples,
+                                     float *mag_out,
+                                     std::size_t fft_length);
+
+#endif // WINDOW_ACCUMULATOR_H
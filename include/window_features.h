@@ -0,0 +1,44 @@
+#ifndef WINDOW_FEATURES_H
+#define WINDOW_FEATURES_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Per-window feature vector fed to the classifier stage.
+// The order is part of the model format (tools/export_classifier.py and the
+// [FEAT] serial log use the same columns).
+enum FeatureIndex {
+    FEAT_TREMOR_RMS_G = 0,   // band RMS 3–5 Hz (g)
+    FEAT_DYSK_RMS_G,         // band RMS 5–7 Hz (g)
+    FEAT_GAIT_RMS_G,         // band RMS 0.5–3 Hz (g)
+    FEAT_DOMINANT_HZ,        // frequency of the largest non-DC bin
+    FEAT_SPECTRAL_ENTROPY,   // normalised Shannon entropy of the power spectrum, 0..1
+    FEAT_CADENCE_HZ,         // step rate (steps / window length)
+    FEAT_MAG_VARIANCE_G2,    // variance of |a| over the window (g^2)
+    NUM_FEATURES
+};
+
+struct FeatureVector {
+    float v[NUM_FEATURES];
+};
+
+// Column names, in FeatureIndex order
+extern const char *const FEATURE_NAMES[NUM_FEATURES];
+
+// Build the feature vector from per-window quantities that are already
+// reduced (spectrum, step count, variance of |a|); cost does not depend on
+// the window length. Used with the streaming WindowAccumulator.
+FeatureVector build_features(const float *spectrum_mag,
+                             std::size_t spectrum_bins,
+                             std::uint16_t step_count,
+                             float mag_variance);
+
+// Build the feature vector for one window from the magnitude signal,
+// its single-sided magnitude spectrum and the step count
+FeatureVector extract_features(const float *mag,
+                               std::size_t n,
+                               const float *spectrum_mag,
+                               std::size_t spectrum_bins,
+                               std::uint16_t step_count);
+
+#endif // WINDOW_FEATURES_H
@@ -0,0 +1,62 @@
+#ifndef WINDOW_HISTORY_H
+#define WINDOW_HISTORY_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "config.h"
+#include "window_features.h"
+
+// Ring of the last HISTORY_WINDOWS feature vectors (band RMS values and the
+// other per-window features) with rolling statistics per feature:
+//   - exponential moving average (HISTORY_EMA_ALPHA),
+//   - minimum / maximum over the ring (monotonic queues of ring positions),
+//   - least-squares slope over the ring (running sums of y and x*y).
+// Pushing a window costs O(1) amortised per feature; reading a trend is O(1).
+// Old spectra are never kept or recomputed, only their feature vectors.
+
+struct TrendQueue {
+    std::uint32_t seq[HISTORY_WINDOWS];   // window sequence numbers, oldest first
+    std::size_t   head;
+    std::size_t   count;
+};
+
+struct WindowHistory {
+    FeatureVector ring[HISTORY_WINDOWS];
+    std::uint32_t pushed;                 // windows pushed since reset
+
+    float ema[NUM_FEATURES];
+    float sum_y[NUM_FEATURES];            // over the ring
+    float sum_xy[NUM_FEATURES];           // x = 0 for the oldest window in the ring
+
+    TrendQueue min_q[NUM_FEATURES];       // increasing values
+    TrendQueue max_q[NUM_FEATURES];       // decreasing values
+};
+
+struct FeatureTrend {
+    float ema;
+    float min;
+    float max;
+    float slope;                          // per window; 0 with fewer than 2 windows
+};
+
+void history_reset(WindowHistory &h);
+
+// Add the feature vector of the window that just closed; the oldest one
+// drops out once HISTORY_WINDOWS are held
+void history_push(WindowHistory &h, const FeatureVector &features);
+
+// Windows currently held (0 .. HISTORY_WINDOWS)
+std::size_t history_count(const WindowHistory &h);
+
+// Rolling statistics of one feature over the windows held
+FeatureTrend history_trend(const WindowHistory &h, FeatureIndex feature);
+
+// Feature vector age windows ago (0 = latest); age < history_count(h)
+const FeatureVector &history_at(const WindowHistory &h, std::size_t age);
+
+// Reference: the same statistics recomputed from the ring (min / max / slope
+// in O(HISTORY_WINDOWS); ema is taken from the running state)
+FeatureTrend history_trend_reference(const WindowHistory &h, FeatureIndex feature);
+
+#endif // WINDOW_HISTORY_H
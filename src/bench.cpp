@@ -0,0 +1,205 @@
+#include "bench.h"
+#include "classifier.h"
+#include "config.h"
+#include "decimator.h"
+#include "window_features.h"
+#include "fft_utils.h"
+#include "profiling.h"
+#include "window_accumulator.h"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+// Input block: interleaved XYZ sets at the oversampled rate (~2.5 s @ 208 Hz)
+static constexpr std::size_t BENCH_INPUT_SETS = 512;
+static constexpr int         BENCH_REPEATS    = 20;
+
+static std::int16_t g_bench_in[BENCH_INPUT_SETS * 3];
+static std::int16_t g_bench_out[3][BENCH_INPUT_SETS / DECIM_FACTOR + 1];
+
+// One analysis window for the per-window stages
+static float g_bench_mag[SAMPLES_PER_WINDOW];
+static float g_bench_spectrum[FFT_LENGTH / 2];
+static float g_bench_axes[3][SAMPLES_PER_WINDOW];
+static WindowAccumulator g_bench_acc;
+
+// Small deterministic PRNG so host and target see identical data
+static std::uint32_t g_bench_seed = 0x12345678u;
+
+static std::int16_t bench_noise(int amplitude)
+{
+    g_bench_seed = g_bench_seed * 1664525u + 1013904223u;
+    return static_cast<std::int16_t>(static_cast<int>(g_bench_seed >> 16) % (2 * amplitude + 1) - amplitude);
+}
+
+// 1 g on Z plus a 4 Hz "tremor" and a 60 Hz out-of-band component on X/Y
+static void bench_fill_input()
+{
+    const float one_g = 1.0f / ACC_G_PER_LSB;
+
+    for (std::size_t i = 0; i < BENCH_INPUT_SETS; ++i) {
+        const float t = static_cast<float>(i) / ACQ_ODR_HZ;
+        const float tremor = 0.05f * one_g * std::sin(2.0f * static_cast<float>(M_PI) * 4.0f * t);
+        const float hf     = 0.05f * one_g * std::sin(2.0f * static_cast<float>(M_PI) * 60.0f * t);
+
+        g_bench_in[3 * i + 0] = static_cast<std::int16_t>(tremor + hf) + bench_noise(200);
+        g_bench_in[3 * i + 1] = static_cast<std::int16_t>(hf) + bench_noise(200);
+        g_bench_in[3 * i + 2] = static_cast<std::int16_t>(one_g + tremor) + bench_noise(200);
+    }
+}
+
+static void bench_decimator(bench_print_fn print)
+{
+    DecimatorState st[3];
+    for (int a = 0; a < 3; ++a) {
+        decimator_reset(st[a]);
+    }
+
+    std::uint32_t best = 0xFFFFFFFFu;
+
+    for (int r = 0; r < BENCH_REPEATS; ++r) {
+        const std::uint32_t t0 = prof_now();
+        for (int a = 0; a < 3; ++a) {
+            decimator_process(st[a], &g_bench_in[a], BENCH_INPUT_SETS, 3, g_bench_out[a], 1);
+        }
+        const std::uint32_t dt = prof_now() - t0;
+        if (dt < best) {
+            best = dt;
+        }
+    }
+
+    const float samples = static_cast<float>(BENCH_INPUT_SETS * 3);
+    print("[BENCH] decimator M=%u taps=%u: %.2f ticks/sample, %.1f ns/sample (input rate %.0f Hz, tick %lu Hz)\r\n",
+          static_cast<unsigned>(DECIM_FACTOR),
+          static_cast<unsigned>(DECIM_TAPS),
+          static_cast<float>(best) / samples,
+          prof_ticks_to_ns(best) / samples,
+          ACQ_ODR_HZ,
+          static_cast<unsigned long>(prof_tick_hz()));
+}
+
+// Best-of-BENCH_REPEATS ticks for one call of a per-window stage
+template <typename F>
+static std::uint32_t bench_best(F &&fn)
+{
+    std::uint32_t best = 0xFFFFFFFFu;
+    for (int r = 0; r < BENCH_REPEATS; ++r) {
+        const std::uint32_t t0 = prof_now();
+        fn();
+        const std::uint32_t dt = prof_now() - t0;
+        if (dt < best) {
+            best = dt;
+        }
+    }
+    return best;
+}
+
+// Feature extraction and both classifier stages, per 3 s window
+static void bench_classifier(bench_print_fn print)
+{
+    for (std::size_t i = 0; i < SAMPLES_PER_WINDOW; ++i) {
+        const float t = static_cast<float>(i) / SAMPLE_FREQUENCY_HZ;
+        g_bench_mag[i] = 1.0f + 0.08f * std::sin(2.0f * static_cast<float>(M_PI) * 4.2f * t)
+                       + 0.001f * static_cast<float>(bench_noise(100));
+    }
+    compute_fft_magnitude(g_bench_mag, SAMPLES_PER_WINDOW, g_bench_spectrum, FFT_LENGTH);
+
+    FeatureVector fv{};
+    const std::uint32_t t_feat = bench_best([&fv]() {
+        fv = extract_features(g_bench_mag, SAMPLES_PER_WINDOW, g_bench_spectrum, FFT_LENGTH / 2, 0);
+    });
+
+    // volatile sink so the classifier calls are not optimised away
+    volatile std::uint8_t sink = 0;
+    const std::uint32_t t_thr = bench_best([&fv, &sink]() {
+        sink = classify_thresholds(fv).tremor_level;
+    });
+    const std::uint32_t t_model = bench_best([&fv, &sink]() {
+        sink = classify_model(fv).tremor_level;
+    });
+    (void)sink;
+
+    print("[BENCH] extract_features: %lu ticks/window (%.1f us)\r\n",
+          static_cast<unsigned long>(t_feat), prof_ticks_to_ns(t_feat) / 1000.0f);
+    print("[BENCH] classify_thresholds: %lu ticks/window (%.2f us)\r\n",
+          static_cast<unsigned long>(t_thr), prof_ticks_to_ns(t_thr) / 1000.0f);
+    print("[BENCH] classify_model: %lu ticks/window (%.2f us)\r\n",
+          static_cast<unsigned long>(t_model), prof_ticks_to_ns(t_model) / 1000.0f);
+}
+
+// Window pipeline: batch passes at window close vs the per-sample accumulator.
+// The batch path pays everything when the window closes; the streaming path
+// spreads the work over the samples and only finalises at close.
+static void bench_window(bench_print_fn print)
+{
+    for (std::size_t i = 0; i < SAMPLES_PER_WINDOW; ++i) {
+        const float t = static_cast<float>(i) / SAMPLE_FREQUENCY_HZ;
+        const float tremor = 0.08f * std::sin(2.0f * static_cast<float>(M_PI) * 4.2f * t);
+        g_bench_axes[0][i] = tremor + 0.001f * static_cast<float>(bench_noise(100));
+        g_bench_axes[1][i] = 0.001f * static_cast<float>(bench_noise(100));
+        g_bench_axes[2][i] = 1.0f + tremor + 0.001f * static_cast<float>(bench_noise(100));
+    }
+
+    FeatureVector fv{};
+    const std::uint32_t t_batch = bench_best([&fv]() {
+        compute_magnitude(g_bench_axes[0], g_bench_axes[1], g_bench_axes[2],
+                          SAMPLES_PER_WINDOW, g_bench_mag);
+        const std::uint16_t steps = estimate_step_count(g_bench_mag, SAMPLES_PER_WINDOW);
+        compute_fft_magnitude(g_bench_mag, SAMPLES_PER_WINDOW, g_bench_spectrum, FFT_LENGTH);
+        fv = extract_features(g_bench_mag, SAMPLES_PER_WINDOW,
+                              g_bench_spectrum, FFT_LENGTH / 2, steps);
+    });
+
+    // Per-sample cost: best-of-runs average, and the worst single push seen
+    std::uint32_t push_total_best = 0xFFFFFFFFu;
+    std::uint32_t push_worst = 0;
+    std::uint32_t t_close = 0xFFFFFFFFu;
+    for (int r = 0; r < BENCH_REPEATS; ++r) {
+        window_acc_reset(g_bench_acc);
+        std::uint32_t total = 0;
+        for (std::size_t i = 0; i < SAMPLES_PER_WINDOW; ++i) {
+            const std::uint32_t t0 = prof_now();
+            window_acc_push(g_bench_acc, g_bench_axes[0][i], g_bench_axes[1][i], g_bench_axes[2][i]);
+            const std::uint32_t dt = prof_now() - t0;
+            total += dt;
+            if (dt > push_worst) {
+                push_worst = dt;
+            }
+        }
+        if (total < push_total_best) {
+            push_total_best = total;
+        }
+
+        const std::uint32_t t0 = prof_now();
+        std::uint16_t steps = 0;
+        float variance = 0.0f;
+        window_acc_finish(g_bench_acc, g_bench_spectrum, steps, variance);
+        fv = build_features(g_bench_spectrum, ACC_SPECTRUM_BINS, steps, variance);
+        const std::uint32_t dt = prof_now() - t0;
+        if (dt < t_close) {
+            t_close = dt;
+        }
+    }
+    (void)fv;
+
+    const float push_mean = static_cast<float>(push_total_best) / static_cast<float>(SAMPLES_PER_WINDOW);
+    print("[BENCH] window batch close (mag+steps+fft+features): %lu ticks (%.1f us)\r\n",
+          static_cast<unsigned long>(t_batch), prof_ticks_to_ns(t_batch) / 1000.0f);
+    print("[BENCH] window_acc_push: %.1f ticks/sample mean, %lu worst (%.2f us worst)\r\n",
+          push_mean, static_cast<unsigned long>(push_worst), prof_ticks_to_ns(push_worst) / 1000.0f);
+    print("[BENCH] window_acc close (finish+features): %lu ticks (%.1f us)\r\n",
+          static_cast<unsigned long>(t_close), prof_ticks_to_ns(t_close) / 1000.0f);
+}
+
+void run_benchmarks(bench_print_fn print)
+{
+    prof_init();
+    bench_fill_input();
+
+    print("[BENCH] start (best of %d runs)\r\n", BENCH_REPEATS);
+    bench_decimator(print);
+    bench_classifier(print);
+    bench_window(print);
+    print("[BENCH] done\r\n");
+}
@@ -7,6 +7,8 @@
 #include "ble/gatt/GattCharacteristic.h"
 #include "ble/gatt/GattService.h"
 
+#include <cstring>
+
 using namespace std::chrono_literals;
 
 // Global BLE instance; avoid naming it 'ble' to prevent conflicts with namespace ble
@@ -19,20 +21,27 @@ static ble::AdvertisingDataBuilder adv_builder(adv_buffer);
 // Device name shown on the phone (we place it in the advertising packet)
 static const char DEVICE_NAME[] = "RTES-F25";
 
-// Custom Service / Char UUIDs (chosen from 0xF250..0xF253)
+// Custom Service / Char UUIDs (chosen from 0xF250..0xF254)
 static const UUID SERVICE_UUID(0xF250);
 static const UUID TREMOR_UUID(0xF251);
 static const UUID DYSK_UUID(0xF252);
 static const UUID FOG_UUID(0xF253);
+static const UUID HEALTH_UUID(0xF254);
 
 // Three levels (0..3)
 static uint8_t tremor_level = 0;
 static uint8_t dysk_level   = 0;
 static uint8_t fog_level    = 0;
 
+// Sampling health counters, 4x uint16 little-endian:
+// dropped samples, resampled samples, late windows, deadline misses
+static constexpr std::size_t HEALTH_FIELDS = 4;
+static uint8_t health_value[2 * HEALTH_FIELDS] = {0};
+
 static GattCharacteristic *tremor_char = nullptr;
 static GattCharacteristic *dysk_char   = nullptr;
 static GattCharacteristic *fog_char    = nullptr;
+static GattCharacteristic *health_char = nullptr;
 static GattService        *rtes_service = nullptr;
 
 static bool g_ble_ready = false;
@@ -51,7 +60,7 @@ static void on_ble_init_complete(ble::BLE::InitializationCompleteCallbackContext
 
     printf("[BLE] init done.\r\n");
 
-    // 1. Create three characteristics (read + notify)
+    // 1. Create the characteristics (read + notify)
     tremor_level = 0;
     dysk_level   = 0;
     fog_level    = 0;
@@ -83,7 +92,16 @@ static void on_ble_init_complete(ble::BLE::InitializationCompleteCallbackContext
         GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_NOTIFY
     );
 
-    GattCharacteristic *char_table[] = { tremor_char, dysk_char, fog_char };
+    health_char = new GattCharacteristic(
+        HEALTH_UUID,
+        health_value,
+        sizeof(health_value),
+        sizeof(health_value),
+        GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_READ |
+        GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_NOTIFY
+    );
+
+    GattCharacteristic *char_table[] = { tremor_char, dysk_char, fog_char, health_char };
 
     rtes_service = new GattService(
         SERVICE_UUID,
@@ -210,6 +228,62 @@ void ble_service_update(uint8_t tremor, uint8_t dyskinesia, uint8_t fog)
     }
 }
 
+void ble_service_update_health(uint16_t dropped_samples,
+                               uint16_t resampled_samples,
+                               uint16_t late_windows,
+                               uint16_t deadline_misses)
+{
+    if (!g_ble_ready || !health_char) {
+        return;
+    }
+
+    const uint16_t fields[HEALTH_FIELDS] = {
+        dropped_samples, resampled_samples, late_windows, deadline_misses
+    };
+
+    uint8_t value[sizeof(health_value)];
+    for (std::size_t i = 0; i < HEALTH_FIELDS; ++i) {
+        value[2 * i]     = static_cast<uint8_t>(fields[i] & 0xFF);
+        value[2 * i + 1] = static_cast<uint8_t>(fields[i] >> 8);
+    }
+
+    if (memcmp(value, health_value, sizeof(health_value)) == 0) {
+        return;
+    }
+
+    memcpy(health_value, value, sizeof(health_value));
+    g_ble.gattServer().write(
+        health_char->getValueHandle(),
+        health_value,
+        sizeof(health_value)
+    );
+}
+
+void ble_service_refresh()
+{
+    if (!g_ble_ready) {
+        return;
+    }
+
+    // Writing a value, even an unchanged one, notifies subscribed clients
+    GattServer &server = g_ble.gattServer();
+    if (tremor_char) {
+        server.write(tremor_char->getValueHandle(), &tremor_level, sizeof(tremor_level));
+    }
+    if (dysk_char) {
+        server.write(dysk_char->getValueHandle(), &dysk_level, sizeof(dysk_level));
+    }
+    if (fog_char) {
+        server.write(fog_char->getValueHandle(), &fog_level, sizeof(fog_level));
+    }
+    if (health_char) {
+        server.write(health_char->getValueHandle(), health_value, sizeof(health_value));
+    }
+
+    printf("[BLE] refresh: tremor=%u, dysk=%u, fog=%u\r\n",
+           tremor_level, dysk_level, fog_level);
+}
+
 // Call periodically from the main loop so BLE events are processed
 void ble_service_process()
 {
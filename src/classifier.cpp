@@ -0,0 +1,79 @@
+#include "classifier.h"
+#include "classifier_model.h"
+#include "config.h"
+#include "detector.h"
+
+#include <cmath>
+
+static_assert(CLF_NUM_HEADS == 2, "model must have a tremor and a dyskinesia head");
+static_assert(CLF_NUM_HEADS * CLF_TREES_PER_HEAD * CLF_MAX_DEPTH <= CLASSIFIER_MAX_NODE_VISITS,
+              "classifier model exceeds CLASSIFIER_MAX_NODE_VISITS");
+
+ClassifierOutput classify_thresholds(const FeatureVector &features)
+{
+    ClassifierOutput out{};
+
+    // Tremor / dyskinesia intensity classification
+    // (thresholds can be tuned based on experimental data)
+    out.tremor_level = classify_level(features.v[FEAT_TREMOR_RMS_G],
+                                      TREMOR_LEVEL1_RMS_G,
+                                      TREMOR_LEVEL2_RMS_G,
+                                      TREMOR_LEVEL3_RMS_G);
+
+    out.dyskinesia_level = classify_level(features.v[FEAT_DYSK_RMS_G],
+                                          DYSK_LEVEL1_RMS_G,
+                                          DYSK_LEVEL2_RMS_G,
+                                          DYSK_LEVEL3_RMS_G);
+    return out;
+}
+
+// Walk every tree of one head and return the level with the highest summed score
+static std::uint8_t run_head(std::size_t head, const std::int8_t *q)
+{
+    std::int32_t scores[4] = {0, 0, 0, 0};
+
+    for (std::size_t t = 0; t < CLF_TREES_PER_HEAD; ++t) {
+        std::uint16_t n = CLF_TREE_ROOT[head][t];
+
+        // Depth-bounded descent; a well-formed model reaches a leaf in time
+        for (std::size_t d = 0; d < CLF_MAX_DEPTH && CLF_NODES[n].feature >= 0; ++d) {
+            const ClassifierNode &node = CLF_NODES[n];
+            n = (q[node.feature] <= node.threshold) ? node.left : node.right;
+        }
+
+        // A model deeper than CLF_MAX_DEPTH (or a bad leaf index) would read
+        // past the leaf table; such a tree does not vote
+        if (CLF_NODES[n].feature >= 0 || CLF_NODES[n].left >= CLF_NUM_LEAVES) {
+            continue;
+        }
+
+        const std::int8_t *leaf = CLF_LEAF_SCORES[CLF_NODES[n].left];
+        for (int c = 0; c < 4; ++c) {
+            scores[c] += leaf[c];
+        }
+    }
+
+    // Ties go to the lower level
+    std::uint8_t best = 0;
+    for (std::uint8_t c = 1; c < 4; ++c) {
+        if (scores[c] > scores[best]) {
+            best = c;
+        }
+    }
+    return best;
+}
+
+ClassifierOutput classify_model(const FeatureVector &features)
+{
+    std::int8_t q[NUM_FEATURES];
+    for (std::size_t i = 0; i < NUM_FEATURES; ++i) {
+        const float v = std::floor(features.v[i] * CLF_FEATURE_INV_SCALE[i] + 0.5f) +
+                        static_cast<float>(CLF_FEATURE_ZERO_POINT[i]);
+        q[i] = static_cast<std::int8_t>(v < -128.0f ? -128 : (v > 127.0f ? 127 : static_cast<int>(v)));
+    }
+
+    ClassifierOutput out{};
+    out.tremor_level     = run_head(0, q);
+    out.dyskinesia_level = run_head(1, q);
+    return out;
+}
@@ -0,0 +1,167 @@
+#include "decimator.h"
+
+#include <cstring>
+
+// ------------------------------------------------------------
+// Compile-time coefficient generation
+// ------------------------------------------------------------
+//
+// Hamming-windowed sinc with unity DC gain, quantised to Q15.
+// Everything below is evaluated by the compiler; only the final
+// int16 table ends up in flash.
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+
+// Taylor series sine, good to ~1e-13 after reduction to [-pi, pi]
+constexpr double cx_sin(double x)
+{
+    while (x > kPi) {
+        x -= 2.0 * kPi;
+    }
+    while (x < -kPi) {
+        x += 2.0 * kPi;
+    }
+
+    double term = x;
+    double sum  = x;
+    for (int i = 1; i < 13; ++i) {
+        term *= -x * x / static_cast<double>((2 * i) * (2 * i + 1));
+        sum += term;
+    }
+    return sum;
+}
+
+constexpr double cx_cos(double x)
+{
+    return cx_sin(x + kPi / 2.0);
+}
+
+constexpr long cx_round(double x)
+{
+    return (x >= 0.0) ? static_cast<long>(x + 0.5) : -static_cast<long>(-x + 0.5);
+}
+
+// Coefficients re-ordered per branch: branch b holds h[j * M + b], j = 0..L-1
+struct DecimatorCoeffs {
+    std::int16_t branch[DECIM_FACTOR][DECIM_TAPS_PER_PHASE];
+    std::int16_t proto[DECIM_TAPS];
+};
+
+constexpr DecimatorCoeffs make_coeffs()
+{
+    DecimatorCoeffs c{};
+
+    // Normalised cutoff in cycles per input sample
+    const double fc     = static_cast<double>(DECIM_CUTOFF_HZ) / static_cast<double>(ACQ_ODR_HZ);
+    const double centre = static_cast<double>(DECIM_TAPS - 1) / 2.0;
+
+    double h[DECIM_TAPS] = {};
+    double sum = 0.0;
+
+    for (std::size_t k = 0; k < DECIM_TAPS; ++k) {
+        const double t = static_cast<double>(k) - centre;
+        const double x = 2.0 * kPi * fc * t;
+        const double sinc = (t == 0.0) ? 2.0 * fc : cx_sin(x) / (kPi * t);
+        const double w = (DECIM_TAPS > 1)
+            ? 0.54 - 0.46 * cx_cos(2.0 * kPi * static_cast<double>(k) / static_cast<double>(DECIM_TAPS - 1))
+            : 1.0;
+        h[k] = sinc * w;
+        sum += h[k];
+    }
+
+    // Quantise with unity DC gain, then push the rounding residue into the
+    // centre tap so the Q15 taps sum to exactly 32768
+    long qsum = 0;
+    for (std::size_t k = 0; k < DECIM_TAPS; ++k) {
+        const long q = cx_round(h[k] / sum * 32768.0);
+        c.proto[k] = static_cast<std::int16_t>(q);
+        qsum += q;
+    }
+    c.proto[DECIM_TAPS / 2] = static_cast<std::int16_t>(c.proto[DECIM_TAPS / 2] + (32768 - qsum));
+
+    for (std::size_t b = 0; b < DECIM_FACTOR; ++b) {
+        for (std::size_t j = 0; j < DECIM_TAPS_PER_PHASE; ++j) {
+            c.branch[b][j] = c.proto[j * DECIM_FACTOR + b];
+        }
+    }
+
+    return c;
+}
+
+constexpr DecimatorCoeffs kCoeffs = make_coeffs();
+
+static_assert(DECIM_FACTOR >= 1, "decimation factor must be >= 1");
+static_assert(DECIM_CUTOFF_HZ < SAMPLE_FREQUENCY_HZ / 2.0f,
+              "decimator cutoff must be below the output Nyquist frequency");
+
+} // namespace
+
+// ------------------------------------------------------------
+// Runtime
+// ------------------------------------------------------------
+
+void decimator_reset(DecimatorState &st)
+{
+    std::memset(st.delay, 0, sizeof(st.delay));
+    st.pos   = 0;
+    st.phase = 0;
+    st.acc   = 0;
+}
+
+// Output y[m] = sum_k h[k] x[mM - k]. Split k = jM + b:
+//   branch 0 sees x[mM], x[(m-1)M], ...
+//   branch b sees x[mM - b], x[(m-1)M - b], ...
+// so inside one output block the samples arrive as branch M-1, M-2, ..., 1, 0
+// and the output is complete once branch 0 has been added.
+//
+// Accumulator headroom: |x| <= 32768 and sum|h| < 1.1 * 32768 (Q15), so the
+// int32 accumulator stays below ~1.2e9.
+std::size_t decimator_process(DecimatorState &st,
+                              const std::int16_t *in,
+                              std::size_t n,
+                              std::size_t in_stride,
+                              std::int16_t *out,
+                              std::size_t out_stride)
+{
+    constexpr std::size_t L = DECIM_TAPS_PER_PHASE;
+    std::size_t produced = 0;
+
+    for (std::size_t i = 0; i < n; ++i) {
+        const std::int16_t x = in[i * in_stride];
+        const std::size_t b = (st.phase == 0) ? 0 : DECIM_FACTOR - st.phase;
+
+        std::int16_t *line = st.delay[b];
+        line[st.pos]     = x;
+        line[st.pos + L] = x;
+
+        const std::int16_t *win = &line[st.pos];
+        const std::int16_t *h   = kCoeffs.branch[b];
+        std::int32_t acc = st.acc;
+        for (std::size_t j = 0; j < L; ++j) {
+            acc += static_cast<std::int32_t>(h[j]) * win[j];
+        }
+
+        if (b == 0) {
+            // Round Q15 -> Q0 and saturate
+            std::int32_t y = (acc + (1 << 14)) >> 15;
+            if (y > 32767) {
+                y = 32767;
+            } else if (y < -32768) {
+                y = -32768;
+            }
+            out[produced * out_stride] = static_cast<std::int16_t>(y);
+            ++produced;
+
+            st.acc = 0;
+            st.pos = (st.pos == 0) ? L - 1 : st.pos - 1;
+        } else {
+            st.acc = acc;
+        }
+
+        st.phase = (st.phase + 1 == DECIM_FACTOR) ? 0 : st.phase + 1;
+    }
+
+    return produced;
+}
@@ -3,14 +3,24 @@
 
 #include <cmath>
 
-// Global internal state used for cross-window FOG detection
-// (i.e. to detect a sudden stop after a period of walking)
-static std::size_t g_consecutive_walking_windows = 0;
-
-static std::uint8_t classify_level(float rms_g,
-                                   float l1,
-                                   float l2,
-                                   float l3)
+// Internal FOG state for the single-wearer detect_conditions overload
+static FogState g_fog_state = {0};
+
+// Classifier stage used by detect_conditions
+static const classifier_fn g_classifier = CLASSIFIER_USE_MODEL ? classify_model : classify_thresholds;
+
+// Band bin ranges [first, end) for integrate_bands, derived once from the
+// same float comparisons the reference uses so both select identical bins
+static bool        g_band_ranges_ready = false;
+static std::size_t g_tremor_first = 0;
+static std::size_t g_tremor_end   = 0;
+static std::size_t g_dysk_first   = 0;
+static std::size_t g_dysk_end     = 0;
+
+std::uint8_t classify_level(float rms_g,
+                            float l1,
+                            float l2,
+                            float l3)
 {
     if (rms_g < l1) {
         return 0;
@@ -23,21 +33,13 @@ static std::uint8_t classify_level(float rms_g,
     }
 }
 
-DetectionResult detect_conditions(const float *spectrum_mag,
-                                  std::size_t spectrum_bins,
-                                  std::uint16_t step_count)
+void integrate_bands_reference(const float *spectrum_mag,
+                               std::size_t spectrum_bins,
+                               float &tremor_rms_g,
+                               float &dysk_rms_g)
 {
-    DetectionResult res{};
-    res.tremor_level      = 0;
-    res.dyskinesia_level  = 0;
-    res.fog_level         = 0;
-    res.tremor_band_rms_g = 0.0f;
-    res.dyskinesia_band_rms_g = 0.0f;
-    res.step_rate_hz      = 0.0f;
-
-    if (spectrum_bins == 0) {
-        return res;
-    }
+    tremor_rms_g = 0.0f;
+    dysk_rms_g   = 0.0f;
 
     // Frequency resolution: fs / N
     const float df = SAMPLE_FREQUENCY_HZ / static_cast<float>(FFT_LENGTH);
@@ -63,44 +65,112 @@ DetectionResult detect_conditions(const float *spectrum_mag,
     }
 
     if (tremor_bins > 0) {
-        res.tremor_band_rms_g = std::sqrt(tremor_power / static_cast<float>(tremor_bins));
+        tremor_rms_g = std::sqrt(tremor_power / static_cast<float>(tremor_bins));
     }
     if (dysk_bins > 0) {
-        res.dyskinesia_band_rms_g = std::sqrt(dysk_power / static_cast<float>(dysk_bins));
+        dysk_rms_g = std::sqrt(dysk_power / static_cast<float>(dysk_bins));
+    }
+}
+
+static void init_band_ranges()
+{
+    const float df = SAMPLE_FREQUENCY_HZ / static_cast<float>(FFT_LENGTH);
+
+    g_tremor_first = g_tremor_end = 0;
+    g_dysk_first   = g_dysk_end   = 0;
+
+    for (std::size_t k = 1; k < FFT_LENGTH / 2; ++k) {
+        const float f = df * static_cast<float>(k);
+        if (f >= TREMOR_F_MIN_HZ && f < TREMOR_F_MAX_HZ) {
+            if (g_tremor_end == 0) {
+                g_tremor_first = k;
+            }
+            g_tremor_end = k + 1;
+        } else if (f >= DYSK_F_MIN_HZ && f < DYSK_F_MAX_HZ) {
+            if (g_dysk_end == 0) {
+                g_dysk_first = k;
+            }
+            g_dysk_end = k + 1;
+        }
     }
 
-    // Tremor / dyskinesia intensity classification
-    // (thresholds can be tuned based on experimental data)
-    res.tremor_level = classify_level(res.tremor_band_rms_g,
-                                      TREMOR_LEVEL1_RMS_G,
-                                      TREMOR_LEVEL2_RMS_G,
-                                      TREMOR_LEVEL3_RMS_G);
+    g_band_ranges_ready = true;
+}
+
+// Sum of squares over [first, min(end, bins)) -> RMS
+static float band_rms(const float *spectrum_mag,
+                      std::size_t spectrum_bins,
+                      std::size_t first,
+                      std::size_t end)
+{
+    if (end > spectrum_bins) {
+        end = spectrum_bins;
+    }
+    if (first >= end) {
+        return 0.0f;
+    }
+
+    float power = 0.0f;
+    for (std::size_t k = first; k < end; ++k) {
+        power += spectrum_mag[k] * spectrum_mag[k];
+    }
+    return std::sqrt(power / static_cast<float>(end - first));
+}
+
+void integrate_bands(const float *spectrum_mag,
+                     std::size_t spectrum_bins,
+                     float &tremor_rms_g,
+                     float &dysk_rms_g)
+{
+    if (!g_band_ranges_ready) {
+        init_band_ranges();
+    }
+
+    tremor_rms_g = band_rms(spectrum_mag, spectrum_bins, g_tremor_first, g_tremor_end);
+    dysk_rms_g   = band_rms(spectrum_mag, spectrum_bins, g_dysk_first, g_dysk_end);
+}
+
+void fog_state_reset(FogState &fog)
+{
+    fog.consecutive_walking_windows = 0;
+}
+
+DetectionResult detect_conditions(const FeatureVector &features)
+{
+    return detect_conditions(features, g_fog_state);
+}
+
+DetectionResult detect_conditions(const FeatureVector &features, FogState &fog)
+{
+    DetectionResult res{};
+    res.fog_level = 0;
 
-    res.dyskinesia_level = classify_level(res.dyskinesia_band_rms_g,
-                                          DYSK_LEVEL1_RMS_G,
-                                          DYSK_LEVEL2_RMS_G,
-                                          DYSK_LEVEL3_RMS_G);
+    res.tremor_band_rms_g     = features.v[FEAT_TREMOR_RMS_G];
+    res.dyskinesia_band_rms_g = features.v[FEAT_DYSK_RMS_G];
+    res.step_rate_hz          = features.v[FEAT_CADENCE_HZ];
 
-    // Step rate estimate: steps / window time
-    res.step_rate_hz = static_cast<float>(step_count) / WINDOW_SECONDS;
+    // Tremor / dyskinesia levels from the active classifier stage
+    const ClassifierOutput levels = g_classifier(features);
+    res.tremor_level     = levels.tremor_level;
+    res.dyskinesia_level = levels.dyskinesia_level;
 
     // Determine whether current window corresponds to "walking"
     const bool is_walking = (res.step_rate_hz >= 0.5f); // >0.5 Hz considered walking
 
     if (is_walking) {
-        ++g_consecutive_walking_windows;
+        ++fog.consecutive_walking_windows;
         res.fog_level = 0; // If the user is walking, this window is not FOG
     } else {
         // If there were several consecutive walking windows and this one suddenly
         // shows no gait, mark it as a FOG event
-        if (g_consecutive_walking_windows >= FOG_MIN_WALKING_WINDOWS) {
+        if (fog.consecutive_walking_windows >= FOG_MIN_WALKING_WINDOWS) {
             res.fog_level = 1;
         } else {
             res.fog_level = 0;
         }
 
         // Reset consecutive walking window counter regardless
-        g_consecutive_walking_windows = 0;
+        fog.consecutive_walking_windows = 0;
     }
 
     return res;
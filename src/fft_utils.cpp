@@ -72,3 +72,82 @@ void compute_dft_magnitude(const float *time_data,
         mag_out[k] = mag;
     }
 }
+
+// Work buffers and twiddles for compute_fft_magnitude (sized for FFT_LENGTH)
+static float g_fft_re[FFT_LENGTH];
+static float g_fft_im[FFT_LENGTH];
+static float g_twiddle_cos[FFT_LENGTH / 2];
+static float g_twiddle_sin[FFT_LENGTH / 2];
+static bool  g_twiddle_ready = false;
+
+static void init_twiddles()
+{
+    // Computed in double once so the table itself adds no rounding drift
+    for (std::size_t i = 0; i < FFT_LENGTH / 2; ++i) {
+        const double angle = 2.0 * M_PI * static_cast<double>(i) / static_cast<double>(FFT_LENGTH);
+        g_twiddle_cos[i] = static_cast<float>(std::cos(angle));
+        g_twiddle_sin[i] = static_cast<float>(std::sin(angle));
+    }
+    g_twiddle_ready = true;
+}
+
+void compute_fft_magnitude(const float *time_data,
+                           std::size_t time_samples,
+                           float *mag_out,
+                           std::size_t fft_length)
+{
+    const bool pow2 = fft_length >= 2 && (fft_length & (fft_length - 1)) == 0;
+    if (!pow2 || fft_length > FFT_LENGTH || time_samples == 0 || time_samples > fft_length) {
+        compute_dft_magnitude(time_data, time_samples, mag_out, fft_length);
+        return;
+    }
+
+    if (!g_twiddle_ready) {
+        init_twiddles();
+    }
+
+    // Load with bit-reversed addressing; the tail stays zero-padded
+    std::size_t bits = 0;
+    while ((static_cast<std::size_t>(1) << bits) < fft_length) {
+        ++bits;
+    }
+    for (std::size_t i = 0; i < fft_length; ++i) {
+        std::size_t r = 0;
+        for (std::size_t b = 0; b < bits; ++b) {
+            r |= ((i >> b) & 1u) << (bits - 1 - b);
+        }
+        g_fft_re[r] = (i < time_samples) ? time_data[i] : 0.0f;
+        g_fft_im[r] = 0.0f;
+    }
+
+    // Iterative decimation-in-time butterflies, e^{-j 2 pi k / N}
+    const std::size_t tw_stride_base = FFT_LENGTH / fft_length;
+    for (std::size_t len = 2; len <= fft_length; len <<= 1) {
+        const std::size_t half_len  = len / 2;
+        const std::size_t tw_stride = tw_stride_base * (fft_length / len);
+
+        for (std::size_t start = 0; start < fft_length; start += len) {
+            for (std::size_t j = 0; j < half_len; ++j) {
+                const float wr =  g_twiddle_cos[j * tw_stride];
+                const float wi = -g_twiddle_sin[j * tw_stride];
+
+                const std::size_t a = start + j;
+                const std::size_t b = a + half_len;
+
+                const float tr = g_fft_re[b] * wr - g_fft_im[b] * wi;
+                const float ti = g_fft_re[b] * wi + g_fft_im[b] * wr;
+
+                g_fft_re[b] = g_fft_re[a] - tr;
+                g_fft_im[b] = g_fft_im[a] - ti;
+                g_fft_re[a] += tr;
+                g_fft_im[a] += ti;
+            }
+        }
+    }
+
+    const std::size_t half = fft_length / 2;
+    const float scale = 1.0f / static_cast<float>(time_samples);
+    for (std::size_t k = 0; k < half; ++k) {
+        mag_out[k] = std::sqrt(g_fft_re[k] * g_fft_re[k] + g_fft_im[k] * g_fft_im[k]) * scale;
+    }
+}
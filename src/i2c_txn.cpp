@@ -0,0 +1,206 @@
+#include "i2c_txn.h"
+
+#if defined(__MBED__)
+
+#include "mbed.h"
+
+// The completion interrupt and the thread(s) share the queue indices
+#define I2C_TXN_LOCK()   core_util_critical_section_enter()
+#define I2C_TXN_UNLOCK() core_util_critical_section_exit()
+
+#else
+
+// Host: the simulated bus completes transfers on the calling thread
+#define I2C_TXN_LOCK()   do {} while (0)
+#define I2C_TXN_UNLOCK() do {} while (0)
+
+#endif
+
+static_assert((I2C_TXN_QUEUE_LEN & (I2C_TXN_QUEUE_LEN - 1)) == 0,
+              "I2C_TXN_QUEUE_LEN must be a power of two");
+
+struct I2CTxnSlot {
+    std::uint8_t    addr8;
+    std::uint8_t    tx[2];   // register address [+ value]
+    std::uint8_t    tx_len;
+    std::uint8_t   *rx;
+    std::size_t     rx_len;
+    i2c_txn_done_fn done;
+    void           *user;
+    bool            ok;
+};
+
+// Ring of slots; the free-running counters split it into
+//   [head, active)  finished, callback not yet run
+//   [active, tail)  queued, the one at active is on the bus when g_busy
+static I2CTxnSlot g_slots[I2C_TXN_QUEUE_LEN];
+static volatile std::uint32_t g_head   = 0;  // thread (dispatch)
+static volatile std::uint32_t g_active = 0;  // completion
+static volatile std::uint32_t g_tail   = 0;  // thread (queue)
+static volatile bool          g_busy   = false;
+
+static i2c_start_fn g_start = nullptr;
+static i2c_defer_fn g_defer = nullptr;
+
+static I2CTxnStats g_stats = {};
+
+static I2CTxnSlot &slot(std::uint32_t index)
+{
+    return g_slots[index & (I2C_TXN_QUEUE_LEN - 1)];
+}
+
+// Start queued transfers while the bus is idle. Safe to call from several
+// contexts: only the caller that claims the bus calls the backend, and it
+// does so outside the critical section (the backend may block on a mutex).
+static void kick()
+{
+    for (;;) {
+        I2C_TXN_LOCK();
+        if (g_busy || g_active == g_tail || !g_start) {
+            I2C_TXN_UNLOCK();
+            return;
+        }
+        g_busy = true;
+        I2CTxnSlot &t = slot(g_active);
+        I2C_TXN_UNLOCK();
+
+        if (g_start(t.addr8, t.tx, t.tx_len, t.rx, t.rx_len)) {
+            return;  // i2c_txn_complete() follows (maybe already has)
+        }
+
+        I2C_TXN_LOCK();
+        t.ok = false;
+        ++g_stats.failed;
+        g_active = g_active + 1;
+        g_busy = false;
+        I2C_TXN_UNLOCK();
+    }
+}
+
+static bool enqueue(const I2CTxnSlot &t)
+{
+    I2C_TXN_LOCK();
+    const std::uint32_t depth = g_tail - g_head;
+    if (depth == I2C_TXN_QUEUE_LEN) {
+        ++g_stats.rejected;
+        I2C_TXN_UNLOCK();
+        return false;
+    }
+    slot(g_tail) = t;
+    g_tail = g_tail + 1;
+    ++g_stats.queued;
+    if (depth + 1 > g_stats.max_depth) {
+        g_stats.max_depth = depth + 1;
+    }
+    I2C_TXN_UNLOCK();
+
+    kick();
+    return true;
+}
+
+void i2c_txn_init(i2c_start_fn start, i2c_defer_fn defer)
+{
+    I2C_TXN_LOCK();
+    g_head   = 0;
+    g_active = 0;
+    g_tail   = 0;
+    g_busy   = false;
+    g_start  = start;
+    g_defer  = defer;
+    g_stats  = I2CTxnStats{};
+    I2C_TXN_UNLOCK();
+}
+
+bool i2c_txn_write_reg(std::uint8_t addr8, std::uint8_t reg, std::uint8_t value,
+                       i2c_txn_done_fn done, void *user)
+{
+    I2CTxnSlot t = {};
+    t.addr8  = addr8;
+    t.tx[0]  = reg;
+    t.tx[1]  = value;
+    t.tx_len = 2;
+    t.done   = done;
+    t.user   = user;
+    return enqueue(t);
+}
+
+bool i2c_txn_read_regs(std::uint8_t addr8, std::uint8_t reg, std::uint8_t *buf, std::size_t len,
+                       i2c_txn_done_fn done, void *user)
+{
+    I2CTxnSlot t = {};
+    t.addr8  = addr8;
+    t.tx[0]  = reg;
+    t.tx_len = 1;
+    t.rx     = buf;
+    t.rx_len = len;
+    t.done   = done;
+    t.user   = user;
+    return enqueue(t);
+}
+
+void i2c_txn_complete(bool ok)
+{
+    I2C_TXN_LOCK();
+    if (!g_busy) {
+        I2C_TXN_UNLOCK();
+        return;  // spurious (e.g. after i2c_txn_init)
+    }
+    I2CTxnSlot &t = slot(g_active);
+    t.ok = ok;
+    if (!ok) {
+        ++g_stats.failed;
+    }
+    g_active = g_active + 1;
+    g_busy = false;
+    const bool more = (g_active != g_tail);
+    I2C_TXN_UNLOCK();
+
+    if (!more) {
+        return;
+    }
+    if (!g_defer) {
+        kick();
+    } else {
+        // If this fails, the next i2c_txn_dispatch() restarts the bus
+        (void)g_defer(kick);
+    }
+}
+
+std::size_t i2c_txn_dispatch()
+{
+    std::size_t n = 0;
+
+    for (;;) {
+        I2C_TXN_LOCK();
+        if (g_head == g_active) {
+            I2C_TXN_UNLOCK();
+            break;
+        }
+        // Copy out and free the slot first, so the callback can queue more
+        const I2CTxnSlot t = slot(g_head);
+        g_head = g_head + 1;
+        I2C_TXN_UNLOCK();
+
+        if (t.done) {
+            t.done(t.ok, t.user);
+        }
+        ++n;
+    }
+
+    // Covers a lost deferred restart
+    kick();
+    return n;
+}
+
+bool i2c_txn_pending()
+{
+    I2C_TXN_LOCK();
+    const bool pending = (g_head != g_tail);
+    I2C_TXN_UNLOCK();
+    return pending;
+}
+
+const I2CTxnStats &i2c_txn_stats()
+{
+    return g_stats;
+}
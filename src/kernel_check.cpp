@@ -0,0 +1,567 @@
+#include "kernel_check.h"
+#include "config.h"
+#include "detector.h"
+#include "fft_utils.h"
+#include "profiling.h"
+#include "publish_filter.h"
+#include "window_accumulator.h"
+#include "window_history.h"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+// ------------------------------------------------------------
+// Variants under test and their error budgets
+// ------------------------------------------------------------
+
+typedef void (*spectrum_fn)(const float *time_data, std::size_t time_samples,
+                            float *mag_out, std::size_t fft_length);
+typedef void (*band_fn)(const float *spectrum_mag, std::size_t spectrum_bins,
+                        float &tremor_rms_g, float &dysk_rms_g);
+
+struct SpectrumVariant {
+    const char *name;
+    spectrum_fn fn;
+    float max_abs_err_g;  // per bin and per band RMS
+    float max_rel_err;    // relative to max(|ref|, CHECK_REL_FLOOR_G)
+};
+
+struct BandVariant {
+    const char *name;
+    band_fn fn;
+    float max_abs_err_g;
+    float max_rel_err;
+};
+
+// Reference: compute_dft_magnitude (float DFT, per-term cos/sin)
+static const SpectrumVariant kSpectrumVariants[] = {
+    // Different summation order and exact twiddles; the float DFT reference
+    // itself carries ~1e-6 g of angle rounding error
+    { "fft_radix2", compute_fft_magnitude, 2.0e-5f, 2.0e-3f },
+    // Per-sample partial sums with table twiddles (what the firmware runs)
+    { "streaming_dft", compute_streaming_dft_magnitude, 2.0e-5f, 2.0e-3f },
+};
+
+// Reference: integrate_bands_reference (per-bin frequency test)
+static const BandVariant kBandVariants[] = {
+    // Same bins in the same order: expected to be bit-exact
+    { "bands_indexed", integrate_bands, 1.0e-7f, 1.0e-6f },
+};
+
+// Relative errors are taken against at least this magnitude, so bins that are
+// essentially zero do not dominate (thresholds start at 0.03 g)
+static constexpr float CHECK_REL_FLOOR_G = 1.0e-3f;
+
+static constexpr std::size_t CHECK_RANDOM_SIGNALS = 24;
+static constexpr std::size_t CHECK_SPECTRUM_BINS  = FFT_LENGTH / 2;
+
+// ------------------------------------------------------------
+// Test signals
+// ------------------------------------------------------------
+
+enum SignalKind {
+    SIG_TONES,    // gravity on Z + up to two tones
+    SIG_STEPS,    // gravity + periodic heel-strike pulses on Z
+    SIG_IMPULSE   // gravity + a single spike
+};
+
+struct Tone {
+    float freq_hz;
+    float amp_g[3];  // per axis
+};
+
+struct GoldenSignal {
+    const char *name;
+    SignalKind  kind;
+    Tone        tones[2];
+    float       noise_g;
+};
+
+// Fixed golden set: rest, every level of both bands, band edges, gait and
+// out-of-band content. Expected output is whatever the reference kernels give.
+static const GoldenSignal kGolden[] = {
+    { "rest",            SIG_TONES,   { {0.0f, {0, 0, 0}},          {0.0f, {0, 0, 0}} },          0.0f  },
+    { "rest_noise",      SIG_TONES,   { {0.0f, {0, 0, 0}},          {0.0f, {0, 0, 0}} },          0.01f },
+    { "tremor_4hz_l1",   SIG_TONES,   { {4.0f, {0, 0, 0.09f}},      {0.0f, {0, 0, 0}} },          0.0f  },
+    { "tremor_4hz_l2",   SIG_TONES,   { {4.0f, {0, 0, 0.20f}},      {0.0f, {0, 0, 0}} },          0.0f  },
+    { "tremor_4hz_l3",   SIG_TONES,   { {4.0f, {0.1f, 0, 0.40f}},   {0.0f, {0, 0, 0}} },          0.0f  },
+    { "tremor_edge_3hz", SIG_TONES,   { {3.0f, {0, 0, 0.20f}},      {0.0f, {0, 0, 0}} },          0.0f  },
+    { "dysk_6hz_l1",     SIG_TONES,   { {6.0f, {0, 0, 0.09f}},      {0.0f, {0, 0, 0}} },          0.0f  },
+    { "dysk_6hz_l3",     SIG_TONES,   { {6.0f, {0, 0.1f, 0.40f}},   {0.0f, {0, 0, 0}} },          0.0f  },
+    { "band_edge_5hz",   SIG_TONES,   { {5.0f, {0, 0, 0.20f}},      {0.0f, {0, 0, 0}} },          0.0f  },
+    { "mixed_4_6hz",     SIG_TONES,   { {4.2f, {0, 0, 0.15f}},      {6.3f, {0.05f, 0, 0.15f}} },  0.005f },
+    { "out_of_band",     SIG_TONES,   { {1.0f, {0, 0, 0.30f}},      {12.0f, {0, 0, 0.30f}} },     0.0f  },
+    { "near_nyquist",    SIG_TONES,   { {25.0f, {0, 0, 0.50f}},     {0.0f, {0, 0, 0}} },          0.0f  },
+    { "walking",         SIG_STEPS,   { {1.8f, {0, 0, 0.35f}},      {0.0f, {0, 0, 0}} },          0.02f },
+    { "impulse",         SIG_IMPULSE, { {0.0f, {0, 0, 1.5f}},       {0.0f, {0, 0, 0}} },          0.0f  },
+};
+
+static constexpr std::size_t GOLDEN_COUNT = sizeof(kGolden) / sizeof(kGolden[0]);
+
+static float g_ax[SAMPLES_PER_WINDOW];
+static float g_ay[SAMPLES_PER_WINDOW];
+static float g_az[SAMPLES_PER_WINDOW];
+static float g_mag[SAMPLES_PER_WINDOW];
+static float g_spec_ref[CHECK_SPECTRUM_BINS];
+static float g_spec_var[CHECK_SPECTRUM_BINS];
+
+static std::uint32_t g_check_seed = 0xC0FFEE01u;
+
+// Uniform in [0, 1)
+static float check_rand()
+{
+    g_check_seed = g_check_seed * 1664525u + 1013904223u;
+    return static_cast<float>(g_check_seed >> 8) / 16777216.0f;
+}
+
+static void make_signal(const GoldenSignal &sig)
+{
+    const float two_pi = 2.0f * static_cast<float>(M_PI);
+
+    for (std::size_t i = 0; i < SAMPLES_PER_WINDOW; ++i) {
+        const float t = static_cast<float>(i) / SAMPLE_FREQUENCY_HZ;
+        float v[3] = {0.0f, 0.0f, 1.0f};
+
+        if (sig.kind == SIG_TONES) {
+            for (const Tone &tone : sig.tones) {
+                const float s = std::sin(two_pi * tone.freq_hz * t);
+                for (int a = 0; a < 3; ++a) {
+                    v[a] += tone.amp_g[a] * s;
+                }
+            }
+        } else if (sig.kind == SIG_STEPS) {
+            // Short raised-cosine pulse at the start of every step period
+            const float period = 1.0f / sig.tones[0].freq_hz;
+            const float phase  = std::fmod(t, period) / period;
+            if (phase < 0.15f) {
+                v[2] += sig.tones[0].amp_g[2] * 0.5f * (1.0f - std::cos(two_pi * phase / 0.15f));
+            }
+        } else if (i == SAMPLES_PER_WINDOW / 3) {
+            v[2] += sig.tones[0].amp_g[2];
+        }
+
+        for (int a = 0; a < 3; ++a) {
+            v[a] += sig.noise_g * (2.0f * check_rand() - 1.0f);
+        }
+
+        g_ax[i] = v[0];
+        g_ay[i] = v[1];
+        g_az[i] = v[2];
+    }
+
+    compute_magnitude(g_ax, g_ay, g_az, SAMPLES_PER_WINDOW, g_mag);
+}
+
+// Random signal: two tones anywhere in 0.2..25 Hz, random per-axis amplitude, noise
+static GoldenSignal random_signal()
+{
+    GoldenSignal sig{ "random", SIG_TONES, { {0.0f, {0, 0, 0}}, {0.0f, {0, 0, 0}} }, 0.0f };
+    for (Tone &tone : sig.tones) {
+        tone.freq_hz = 0.2f + 24.8f * check_rand();
+        for (int a = 0; a < 3; ++a) {
+            tone.amp_g[a] = 0.3f * check_rand();
+        }
+    }
+    sig.noise_g = 0.05f * check_rand();
+    return sig;
+}
+
+// ------------------------------------------------------------
+// Error bookkeeping
+// ------------------------------------------------------------
+
+struct ErrorStats {
+    float max_abs;
+    float max_rel;
+    std::size_t abs_at;   // bin index (spectrum) or signal index (bands)
+    std::size_t rel_at;
+};
+
+static void track_error(ErrorStats &st, float ref, float var, std::size_t at)
+{
+    const float abs_err = std::fabs(var - ref);
+    const float denom = (std::fabs(ref) > CHECK_REL_FLOOR_G) ? std::fabs(ref) : CHECK_REL_FLOOR_G;
+    const float rel_err = abs_err / denom;
+
+    if (abs_err > st.max_abs) {
+        st.max_abs = abs_err;
+        st.abs_at  = at;
+    }
+    if (rel_err > st.max_rel) {
+        st.max_rel = rel_err;
+        st.rel_at  = at;
+    }
+}
+
+struct LevelStats {
+    std::size_t total;
+    std::size_t match;
+    std::size_t strict_mismatch;  // mismatch although the reference RMS is clear of every threshold
+};
+
+static bool near_threshold(float rms, float l1, float l2, float l3, float margin)
+{
+    return std::fabs(rms - l1) <= margin || std::fabs(rms - l2) <= margin || std::fabs(rms - l3) <= margin;
+}
+
+static void track_levels(LevelStats &st,
+                         float ref_tremor, float ref_dysk,
+                         float var_tremor, float var_dysk,
+                         float margin)
+{
+    const std::uint8_t rt = classify_level(ref_tremor, TREMOR_LEVEL1_RMS_G, TREMOR_LEVEL2_RMS_G, TREMOR_LEVEL3_RMS_G);
+    const std::uint8_t vt = classify_level(var_tremor, TREMOR_LEVEL1_RMS_G, TREMOR_LEVEL2_RMS_G, TREMOR_LEVEL3_RMS_G);
+    const std::uint8_t rd = classify_level(ref_dysk, DYSK_LEVEL1_RMS_G, DYSK_LEVEL2_RMS_G, DYSK_LEVEL3_RMS_G);
+    const std::uint8_t vd = classify_level(var_dysk, DYSK_LEVEL1_RMS_G, DYSK_LEVEL2_RMS_G, DYSK_LEVEL3_RMS_G);
+
+    st.total += 2;
+    if (rt == vt) {
+        ++st.match;
+    } else if (!near_threshold(ref_tremor, TREMOR_LEVEL1_RMS_G, TREMOR_LEVEL2_RMS_G, TREMOR_LEVEL3_RMS_G, margin)) {
+        ++st.strict_mismatch;
+    }
+    if (rd == vd) {
+        ++st.match;
+    } else if (!near_threshold(ref_dysk, DYSK_LEVEL1_RMS_G, DYSK_LEVEL2_RMS_G, DYSK_LEVEL3_RMS_G, margin)) {
+        ++st.strict_mismatch;
+    }
+}
+
+// Iterate golden signals, then random ones; returns false when done
+static bool next_signal(std::size_t index)
+{
+    if (index < GOLDEN_COUNT) {
+        make_signal(kGolden[index]);
+        return true;
+    }
+    if (index < GOLDEN_COUNT + CHECK_RANDOM_SIGNALS) {
+        make_signal(random_signal());
+        return true;
+    }
+    return false;
+}
+
+static bool within(const ErrorStats &st, float max_abs, float max_rel)
+{
+    return st.max_abs <= max_abs && st.max_rel <= max_rel;
+}
+
+// ------------------------------------------------------------
+// Checks
+// ------------------------------------------------------------
+
+static bool check_spectrum_variant(const SpectrumVariant &v, bench_print_fn print)
+{
+    ErrorStats bins{}, tremor{}, dysk{};
+    LevelStats levels{};
+    std::uint32_t ticks_ref = 0;
+    std::uint32_t ticks_var = 0;
+    std::size_t signals = 0;
+
+    g_check_seed = 0xC0FFEE01u;
+    for (std::size_t s = 0; next_signal(s); ++s, ++signals) {
+        std::uint32_t t0 = prof_now();
+        compute_dft_magnitude(g_mag, SAMPLES_PER_WINDOW, g_spec_ref, FFT_LENGTH);
+        ticks_ref += prof_now() - t0;
+
+        t0 = prof_now();
+        v.fn(g_mag, SAMPLES_PER_WINDOW, g_spec_var, FFT_LENGTH);
+        ticks_var += prof_now() - t0;
+
+        for (std::size_t k = 0; k < CHECK_SPECTRUM_BINS; ++k) {
+            track_error(bins, g_spec_ref[k], g_spec_var[k], k);
+        }
+
+        float rt = 0.0f, rd = 0.0f, vt = 0.0f, vd = 0.0f;
+        integrate_bands_reference(g_spec_ref, CHECK_SPECTRUM_BINS, rt, rd);
+        integrate_bands_reference(g_spec_var, CHECK_SPECTRUM_BINS, vt, vd);
+        track_error(tremor, rt, vt, s);
+        track_error(dysk, rd, vd, s);
+        track_levels(levels, rt, rd, vt, vd, v.max_abs_err_g);
+    }
+
+    const bool ok = within(bins, v.max_abs_err_g, v.max_rel_err) &&
+                    within(tremor, v.max_abs_err_g, v.max_rel_err) &&
+                    within(dysk, v.max_abs_err_g, v.max_rel_err) &&
+                    levels.strict_mismatch == 0;
+
+    const float us_ref = prof_ticks_to_ns(ticks_ref) / 1000.0f / static_cast<float>(signals);
+    const float us_var = prof_ticks_to_ns(ticks_var) / 1000.0f / static_cast<float>(signals);
+
+    print("[CHECK] spectrum %s vs compute_dft_magnitude (%u signals)\r\n",
+          v.name, static_cast<unsigned>(signals));
+    print("[CHECK]   bins:   max_abs=%.8f g (bin %u), max_rel=%.1f ppm (bin %u)\r\n",
+          bins.max_abs, static_cast<unsigned>(bins.abs_at),
+          bins.max_rel * 1.0e6f, static_cast<unsigned>(bins.rel_at));
+    print("[CHECK]   tremor: max_abs=%.8f g, max_rel=%.1f ppm; dysk: max_abs=%.8f g, max_rel=%.1f ppm\r\n",
+          tremor.max_abs, tremor.max_rel * 1.0e6f, dysk.max_abs, dysk.max_rel * 1.0e6f);
+    print("[CHECK]   levels: %u/%u match (%u outside threshold margin)\r\n",
+          static_cast<unsigned>(levels.match), static_cast<unsigned>(levels.total),
+          static_cast<unsigned>(levels.strict_mismatch));
+    print("[CHECK]   time:   ref %.1f us, variant %.1f us per call (x%.1f)\r\n",
+          us_ref, us_var, (us_var > 0.0f) ? us_ref / us_var : 0.0f);
+    print("[CHECK]   budget: abs %.8f g, rel %.1f ppm -> %s\r\n",
+          v.max_abs_err_g, v.max_rel_err * 1.0e6f, ok ? "PASS" : "FAIL");
+
+    return ok;
+}
+
+static bool check_band_variant(const BandVariant &v, bench_print_fn print)
+{
+    ErrorStats tremor{}, dysk{};
+    LevelStats levels{};
+    std::uint32_t ticks_ref = 0;
+    std::uint32_t ticks_var = 0;
+    std::size_t signals = 0;
+
+    // Band kernels are tiny; repeat each call to get a measurable time
+    constexpr int repeats = 50;
+
+    g_check_seed = 0xC0FFEE01u;
+    for (std::size_t s = 0; next_signal(s); ++s, ++signals) {
+        compute_dft_magnitude(g_mag, SAMPLES_PER_WINDOW, g_spec_ref, FFT_LENGTH);
+
+        float rt = 0.0f, rd = 0.0f, vt = 0.0f, vd = 0.0f;
+
+        std::uint32_t t0 = prof_now();
+        for (int r = 0; r < repeats; ++r) {
+            integrate_bands_reference(g_spec_ref, CHECK_SPECTRUM_BINS, rt, rd);
+        }
+        ticks_ref += prof_now() - t0;
+
+        t0 = prof_now();
+        for (int r = 0; r < repeats; ++r) {
+            v.fn(g_spec_ref, CHECK_SPECTRUM_BINS, vt, vd);
+        }
+        ticks_var += prof_now() - t0;
+
+        track_error(tremor, rt, vt, s);
+        track_error(dysk, rd, vd, s);
+        track_levels(levels, rt, rd, vt, vd, v.max_abs_err_g);
+    }
+
+    const bool ok = within(tremor, v.max_abs_err_g, v.max_rel_err) &&
+                    within(dysk, v.max_abs_err_g, v.max_rel_err) &&
+                    levels.strict_mismatch == 0;
+
+    const float calls = static_cast<float>(signals) * static_cast<float>(repeats);
+    const float us_ref = prof_ticks_to_ns(ticks_ref) / 1000.0f / calls;
+    const float us_var = prof_ticks_to_ns(ticks_var) / 1000.0f / calls;
+
+    print("[CHECK] bands %s vs integrate_bands_reference (%u signals)\r\n",
+          v.name, static_cast<unsigned>(signals));
+    print("[CHECK]   tremor: max_abs=%.8f g (signal %u), max_rel=%.1f ppm; dysk: max_abs=%.8f g (signal %u), max_rel=%.1f ppm\r\n",
+          tremor.max_abs, static_cast<unsigned>(tremor.abs_at), tremor.max_rel * 1.0e6f,
+          dysk.max_abs, static_cast<unsigned>(dysk.abs_at), dysk.max_rel * 1.0e6f);
+    print("[CHECK]   levels: %u/%u match (%u outside threshold margin)\r\n",
+          static_cast<unsigned>(levels.match), static_cast<unsigned>(levels.total),
+          static_cast<unsigned>(levels.strict_mismatch));
+    print("[CHECK]   time:   ref %.3f us, variant %.3f us per call (x%.1f)\r\n",
+          us_ref, us_var, (us_var > 0.0f) ? us_ref / us_var : 0.0f);
+    print("[CHECK]   budget: abs %.8f g, rel %.1f ppm -> %s\r\n",
+          v.max_abs_err_g, v.max_rel_err * 1.0e6f, ok ? "PASS" : "FAIL");
+
+    return ok;
+}
+
+// Rolling window statistics (window_history) against a recompute over the
+// ring. Min / max must match exactly; the slope error is taken relative to
+// the largest value held.
+static constexpr std::size_t CHECK_HISTORY_PUSHES    = 10 * HISTORY_WINDOWS + 7;
+static constexpr float       CHECK_HISTORY_SLOPE_REL = 1.0e-4f;
+
+static WindowHistory g_check_history;
+
+static bool check_history(bench_print_fn print)
+{
+    history_reset(g_check_history);
+    g_check_seed = 0xC0FFEE01u;
+
+    float max_slope_rel = 0.0f;
+    std::size_t minmax_mismatch = 0;
+    std::uint32_t ticks_push = 0;
+    std::uint32_t ticks_ref  = 0;
+
+    for (std::size_t w = 0; w < CHECK_HISTORY_PUSHES; ++w) {
+        // Per feature: slow drift, noise and an occasional spike, scaled
+        // differently per feature
+        FeatureVector fv;
+        for (std::size_t f = 0; f < NUM_FEATURES; ++f) {
+            const float scale = 0.01f * static_cast<float>(f + 1);
+            const float drift = 0.5f + 0.4f * std::sin(0.05f * static_cast<float>(w) + static_cast<float>(f));
+            const float spike = (check_rand() < 0.05f) ? 2.0f : 0.0f;
+            fv.v[f] = scale * (drift + 0.2f * check_rand() + spike);
+        }
+
+        std::uint32_t t0 = prof_now();
+        history_push(g_check_history, fv);
+        ticks_push += prof_now() - t0;
+
+        for (std::size_t f = 0; f < NUM_FEATURES; ++f) {
+            const FeatureIndex fi = static_cast<FeatureIndex>(f);
+            t0 = prof_now();
+            const FeatureTrend ref = history_trend_reference(g_check_history, fi);
+            ticks_ref += prof_now() - t0;
+            const FeatureTrend var = history_trend(g_check_history, fi);
+
+            if (var.min != ref.min || var.max != ref.max) {
+                ++minmax_mismatch;
+            }
+            const float span = (std::fabs(ref.max) > std::fabs(ref.min)) ? std::fabs(ref.max) : std::fabs(ref.min);
+            const float rel  = std::fabs(var.slope - ref.slope) / ((span > 0.0f) ? span : 1.0f);
+            max_slope_rel = (rel > max_slope_rel) ? rel : max_slope_rel;
+        }
+    }
+
+    const bool ok = (minmax_mismatch == 0) && (max_slope_rel <= CHECK_HISTORY_SLOPE_REL);
+
+    const float windows = static_cast<float>(CHECK_HISTORY_PUSHES);
+    print("[CHECK] history running stats vs recompute (%u windows, ring %u)\r\n",
+          static_cast<unsigned>(CHECK_HISTORY_PUSHES), static_cast<unsigned>(HISTORY_WINDOWS));
+    print("[CHECK]   min/max: %u mismatches; slope: max_rel=%.1f ppm\r\n",
+          static_cast<unsigned>(minmax_mismatch), max_slope_rel * 1.0e6f);
+    print("[CHECK]   time:   recompute %.3f us, push %.3f us per window (all features)\r\n",
+          prof_ticks_to_ns(ticks_ref) / 1000.0f / windows,
+          prof_ticks_to_ns(ticks_push) / 1000.0f / windows);
+    print("[CHECK]   budget: exact min/max, slope rel %.1f ppm -> %s\r\n",
+          CHECK_HISTORY_SLOPE_REL * 1.0e6f, ok ? "PASS" : "FAIL");
+
+    return ok;
+}
+
+// Publish filters (publish_filter) on scripted tremor RMS sequences: the
+// filtered level per window and the gate decisions must match exactly.
+
+static WindowHistory   g_check_pub_history;
+static LevelHysteresis g_check_hyst;
+
+static std::uint8_t ladder_level(float rms)
+{
+    return static_cast<std::uint8_t>((rms >= TREMOR_LEVEL1_RMS_G) +
+                                     (rms >= TREMOR_LEVEL2_RMS_G) +
+                                     (rms >= TREMOR_LEVEL3_RMS_G));
+}
+
+// Run one sequence through history + hysteresis; true if every filtered
+// level matches expected
+static bool hysteresis_case(const float *rms, const std::uint8_t *expected, std::size_t n)
+{
+    history_reset(g_check_pub_history);
+    level_hysteresis_reset(g_check_hyst);
+
+    bool ok = true;
+    for (std::size_t w = 0; w < n; ++w) {
+        FeatureVector fv = {};
+        fv.v[FEAT_TREMOR_RMS_G] = rms[w];
+        history_push(g_check_pub_history, fv);
+        const std::uint8_t level = level_hysteresis_update(g_check_hyst, ladder_level(rms[w]),
+                                                           g_check_pub_history, FEAT_TREMOR_RMS_G,
+                                                           TREMOR_LEVEL1_RMS_G, TREMOR_LEVEL2_RMS_G,
+                                                           TREMOR_LEVEL3_RMS_G);
+        ok = ok && (level == expected[w]);
+    }
+    return ok;
+}
+
+// Next window for the gate: advance the history clock and decide
+static PublishAction gate_window(PublishGate &g, std::uint8_t tremor, std::uint8_t fog)
+{
+    const FeatureVector fv = {};
+    history_push(g_check_pub_history, fv);
+    return publish_gate_update(g, g_check_pub_history, PublishedLevels{tremor, 0, fog});
+}
+
+static bool check_publish_filter(bench_print_fn print)
+{
+    // Enter: a step inside the dead band needs LEVEL_CONFIRM_WINDOWS windows;
+    // one that moves the EMA past it is taken at once
+    static const float        enter_dwell[]     = {0.0f, 0.0f, 0.0f, 0.05f, 0.05f, 0.05f};
+    static const std::uint8_t enter_dwell_exp[] = {0,    0,    0,    0,     1,     1};
+    static const float        enter_clear[]     = {0.025f, 0.025f, 0.025f, 0.065f};
+    static const std::uint8_t enter_clear_exp[] = {0,      0,      0,      1};
+    const bool enter_ok = hysteresis_case(enter_dwell, enter_dwell_exp, 6) &&
+                          hysteresis_case(enter_clear, enter_clear_exp, 4);
+
+    // Exit: the same, going down
+    static const float        exit_dwell[]     = {0.05f, 0.05f, 0.05f, 0.02f, 0.02f};
+    static const std::uint8_t exit_dwell_exp[] = {1,     1,     1,     1,     0};
+    static const float        exit_clear[]     = {0.032f, 0.032f, 0.032f, 0.0f};
+    static const std::uint8_t exit_clear_exp[] = {0,      1,      1,      0};
+    const bool exit_ok = hysteresis_case(exit_dwell, exit_dwell_exp, 5) &&
+                         hysteresis_case(exit_clear, exit_clear_exp, 4);
+
+    // Dwell: RMS alternating around TREMOR_LEVEL1_RMS_G toggles the raw
+    // level every window, the filtered one never
+    static const float        toggle[]     = {0.05f, 0.05f, 0.028f, 0.032f, 0.028f, 0.032f,
+                                              0.028f, 0.032f, 0.028f, 0.032f};
+    static const std::uint8_t toggle_exp[] = {1,     1,     1,      1,      1,      1,
+                                              1,     1,     1,      1};
+    const bool dwell_ok = hysteresis_case(toggle, toggle_exp, 10);
+
+    // Minimum interval: a change right after a publish is held until
+    // PUBLISH_MIN_INTERVAL_WINDOWS windows have passed; FOG is not held
+    PublishGate gate;
+    history_reset(g_check_pub_history);
+    publish_gate_reset(gate);
+    bool interval_ok = (gate_window(gate, 1, 0) == PUBLISH_CHANGE);
+    for (std::uint32_t w = 1; w < PUBLISH_MIN_INTERVAL_WINDOWS; ++w) {
+        interval_ok = interval_ok && (gate_window(gate, 2, 0) == PUBLISH_NONE) && gate.pending;
+    }
+    interval_ok = interval_ok && (gate_window(gate, 2, 0) == PUBLISH_CHANGE) &&
+                  (gate_window(gate, 2, 1) == PUBLISH_CHANGE) &&
+                  (gate.sent == 3) && (gate.held == PUBLISH_MIN_INTERVAL_WINDOWS - 1);
+
+    // Forced refresh: unchanged levels are re-sent every
+    // PUBLISH_REFRESH_WINDOWS windows; a refresh counts for the minimum
+    // interval, and a change restarts the timer
+    bool refresh_ok = true;
+    std::uint32_t refreshes = 0;
+    for (std::uint32_t w = 1; w <= 3 * PUBLISH_REFRESH_WINDOWS; ++w) {
+        const PublishAction a = gate_window(gate, 2, 1);
+        const bool due = (w % PUBLISH_REFRESH_WINDOWS == 0);
+        refresh_ok = refresh_ok && (a == (due ? PUBLISH_REFRESH : PUBLISH_NONE));
+        refreshes += (a == PUBLISH_REFRESH);
+    }
+    for (std::uint32_t w = 1; w < PUBLISH_MIN_INTERVAL_WINDOWS; ++w) {
+        refresh_ok = refresh_ok && (gate_window(gate, 3, 1) == PUBLISH_NONE);
+    }
+    refresh_ok = refresh_ok && (gate_window(gate, 3, 1) == PUBLISH_CHANGE);
+    for (std::uint32_t w = 1; w < PUBLISH_REFRESH_WINDOWS; ++w) {
+        refresh_ok = refresh_ok && (gate_window(gate, 3, 1) == PUBLISH_NONE);
+    }
+    refresh_ok = refresh_ok && (gate_window(gate, 3, 1) == PUBLISH_REFRESH) && (gate.refreshed == refreshes + 1);
+
+    const bool ok = enter_ok && exit_ok && dwell_ok && interval_ok && refresh_ok;
+
+    print("[CHECK] publish filters (dead band %.0f %%, confirm %u, interval %u, refresh %u windows)\r\n",
+          LEVEL_HYSTERESIS_FRAC * 100.0f, static_cast<unsigned>(LEVEL_CONFIRM_WINDOWS),
+          static_cast<unsigned>(PUBLISH_MIN_INTERVAL_WINDOWS), static_cast<unsigned>(PUBLISH_REFRESH_WINDOWS));
+    print("[CHECK]   enter %s, exit %s, dwell %s, min interval %s, refresh %s -> %s\r\n",
+          enter_ok ? "ok" : "WRONG", exit_ok ? "ok" : "WRONG", dwell_ok ? "ok" : "WRONG",
+          interval_ok ? "ok" : "WRONG", refresh_ok ? "ok" : "WRONG", ok ? "PASS" : "FAIL");
+
+    return ok;
+}
+
+bool run_kernel_check(bench_print_fn print)
+{
+    prof_init();
+
+    bool ok = true;
+
+    print("[CHECK] start: %u golden + %u random signals\r\n",
+          static_cast<unsigned>(GOLDEN_COUNT), static_cast<unsigned>(CHECK_RANDOM_SIGNALS));
+
+    for (const SpectrumVariant &v : kSpectrumVariants) {
+        ok = check_spectrum_variant(v, print) && ok;
+    }
+    for (const BandVariant &v : kBandVariants) {
+        ok = check_band_variant(v, print) && ok;
+    }
+    ok = check_history(print) && ok;
+    ok = check_publish_filter(print) && ok;
+
+    print("[CHECK] %s\r\n", ok ? "all variants within budget" : "FAILED: variant(s) over budget");
+    return ok;
+}
@@ -1,50 +1,173 @@
 #include "lsm6dsl_driver.h"
 #include "config.h"
+#include "i2c_txn.h"
 
 // I2C2: PB_11 = SDA, PB_10 = SCL (UM2153: I2C2_SDA / SCL)
 static I2C i2c_lsm(PB_11, PB_10);
 
 // LSM6DSL I2C address: 7-bit = 0x6A => 8-bit write address = 0xD4
-static constexpr int LSM6DSL_I2C_ADDR_WRITE = 0xD4;
-static constexpr int LSM6DSL_I2C_ADDR_READ  = 0xD5;
+// (the read address 0xD5 is derived by the I2C layer)
+static constexpr uint8_t LSM6DSL_I2C_ADDR_WRITE = 0xD4;
 
 // Register addresses
 static constexpr uint8_t REG_WHO_AM_I   = 0x0F;
 static constexpr uint8_t REG_CTRL1_XL   = 0x10; // accelerometer control
 static constexpr uint8_t REG_CTRL2_G    = 0x11; // gyroscope control
 static constexpr uint8_t REG_CTRL3_C    = 0x12; // some global settings
+static constexpr uint8_t REG_CTRL10_C   = 0x19; // TIMER_EN (bit 5)
+static constexpr uint8_t REG_TIMESTAMP0 = 0x40; // 24-bit timestamp, LSB first (to 0x42)
+static constexpr uint8_t REG_TIMESTAMP2 = 0x42; // writing 0xAA resets the counter
+static constexpr uint8_t REG_WAKE_UP_DUR = 0x5C; // TIMER_HR (bit 4): 1 => 25 µs/LSB
+
+// Timestamp counter: 24 bits @ 25 µs/LSB, wraps every ~419 s
+static constexpr uint32_t TIMESTAMP_US_PER_LSB = 25;
+static constexpr uint32_t TIMESTAMP_MASK       = 0x00FFFFFF;
 static constexpr uint8_t REG_OUTX_L_XL  = 0x28; // accel X LSB (continues to ZH)
 
+static constexpr uint32_t I2C_BUS_HZ = 400000;
+
+// Bus time of one 6-byte register read: START, address + register, repeated
+// START, address, 6 data bytes and STOP (9 clocks per byte) ≈ 210 µs at
+// 400 kHz. The timestamp read that follows an accel read latches the counter
+// about this much later than the data bytes went out.
+static constexpr uint32_t ACCEL_READ_BITS = 1 + 2 * 9 + 1 + 9 + 6 * 9 + 1;
+static constexpr uint32_t ACCEL_READ_US   = ACCEL_READ_BITS * 1000000u / I2C_BUS_HZ;
+
+// FIFO registers (oversampled acquisition)
+static constexpr uint8_t REG_FIFO_CTRL3   = 0x08; // FIFO decimation: DEC_FIFO_GYRO / DEC_FIFO_XL
+static constexpr uint8_t REG_FIFO_CTRL5   = 0x0A; // ODR_FIFO[6:3], FIFO_MODE[2:0]
+static constexpr uint8_t REG_FIFO_STATUS1 = 0x3A; // DIFF_FIFO[7:0] (continues to FIFO_STATUS4)
+static constexpr uint8_t REG_FIFO_DATA_OUT_L = 0x3E;
+
+// FIFO_MODE values
+static constexpr uint8_t FIFO_MODE_BYPASS     = 0x00;
+static constexpr uint8_t FIFO_MODE_CONTINUOUS = 0x06;
+
+// CTRL1_XL low bits: LPF1_BW_SEL (bit 1) = ODR/4 digital LPF, BW0_XL (bit 0) = 400 Hz analog AA filter
+static constexpr uint8_t CTRL1_XL_LPF1_BW_SEL = 0x02;
+static constexpr uint8_t CTRL1_XL_BW0_XL      = 0x01;
+
+// ODR_XL / ODR_FIFO code for a given rate (0 = unsupported here)
+static constexpr uint8_t odr_code(float hz)
+{
+    return (hz == 52.0f)  ? 0x03 :
+           (hz == 104.0f) ? 0x04 :
+           (hz == 208.0f) ? 0x05 :
+           (hz == 416.0f) ? 0x06 : 0x00;
+}
+
+static_assert(odr_code(ACQ_ODR_HZ) != 0,
+              "ACQ_OVERSAMPLE_FACTOR must give a 52/104/208/416 Hz ODR");
+
 // WHO_AM_I expected = 0x6A
 static constexpr uint8_t WHO_AM_I_EXPECTED = 0x6A;
 
+// Last raw timestamp and its unwrapped value in µs
+static uint32_t g_ts_last_raw = 0;
+static uint32_t g_ts_us       = 0;
+
+// ------------------------------------------------------------
+// I2C backend for the transaction layer (i2c_txn.h)
+// ------------------------------------------------------------
+
+#if DEVICE_I2C_ASYNCH
+
+// Interrupt context: report the transfer result to the transaction layer
+static void on_i2c_event(int event)
+{
+    const int errors = I2C_EVENT_ERROR | I2C_EVENT_ERROR_NO_SLAVE | I2C_EVENT_TRANSFER_EARLY_NACK;
+    i2c_txn_complete((event & I2C_EVENT_TRANSFER_COMPLETE) && !(event & errors));
+}
+
+// Non-blocking: write tx, repeated start, read rx, then on_i2c_event.
+// The HAL moves the bytes by interrupt or DMA (see set_dma_usage in lsm6dsl_init).
+static bool bus_start(uint8_t addr8, const uint8_t *tx, size_t tx_len, uint8_t *rx, size_t rx_len)
+{
+    const int rc = i2c_lsm.transfer(addr8,
+                                    reinterpret_cast<const char *>(tx), static_cast<int>(tx_len),
+                                    reinterpret_cast<char *>(rx), static_cast<int>(rx_len),
+                                    callback(on_i2c_event),
+                                    I2C_EVENT_ALL);
+    return (rc == 0);
+}
+
+// I2C::transfer locks a mutex, so the next transfer is started from the
+// shared event queue thread rather than from the completion interrupt
+static bool bus_defer(void (*fn)())
+{
+    return mbed_event_queue()->call(fn) != 0;
+}
+
+#else
+
+// Targets without asynchronous I2C: blocking transfer, completed before returning
+static bool bus_start(uint8_t addr8, const uint8_t *tx, size_t tx_len, uint8_t *rx, size_t rx_len)
+{
+    int rc = i2c_lsm.write(addr8, reinterpret_cast<const char *>(tx), static_cast<int>(tx_len), rx_len > 0);
+    if (rc == 0 && rx_len > 0) {
+        rc = i2c_lsm.read(addr8 | 0x01, reinterpret_cast<char *>(rx), static_cast<int>(rx_len));
+    }
+    i2c_txn_complete(rc == 0);
+    return true;
+}
+
+static constexpr i2c_defer_fn bus_defer = nullptr;
+
+#endif
+
+// ------------------------------------------------------------
+// Blocking register access (init, legacy mode) on top of the queue
+// ------------------------------------------------------------
+
+struct SyncTxn {
+    bool done;
+    bool ok;
+};
+
+static void on_sync_done(bool ok, void *user)
+{
+    SyncTxn *t = static_cast<SyncTxn *>(user);
+    t->ok   = ok;
+    t->done = true;
+}
+
+// Wait for a queued transaction; also runs any other completions in order
+static bool wait_sync(SyncTxn &t)
+{
+    while (!t.done) {
+        i2c_txn_dispatch();
+    }
+    return t.ok;
+}
+
 // Write a register
 static bool write_reg(uint8_t reg, uint8_t value)
 {
-    char data[2];
-    data[0] = static_cast<char>(reg);
-    data[1] = static_cast<char>(value);
-    int rc = i2c_lsm.write(LSM6DSL_I2C_ADDR_WRITE, data, 2);
-    return (rc == 0);
+    SyncTxn t = {false, false};
+    if (!i2c_txn_write_reg(LSM6DSL_I2C_ADDR_WRITE, reg, value, on_sync_done, &t)) {
+        return false;
+    }
+    return wait_sync(t);
 }
 
-// Read multiple registers
+// Read multiple registers (register address write, repeated start, read)
 static bool read_regs(uint8_t start_reg, uint8_t *buffer, size_t len)
 {
-    char reg = static_cast<char>(start_reg);
-    // Write register address with repeated start
-    int rc = i2c_lsm.write(LSM6DSL_I2C_ADDR_WRITE, &reg, 1, true);
-    if (rc != 0) {
+    SyncTxn t = {false, false};
+    if (!i2c_txn_read_regs(LSM6DSL_I2C_ADDR_WRITE, start_reg, buffer, len, on_sync_done, &t)) {
         return false;
     }
-    rc = i2c_lsm.read(LSM6DSL_I2C_ADDR_READ, reinterpret_cast<char *>(buffer), len);
-    return (rc == 0);
+    return wait_sync(t);
 }
 
 bool lsm6dsl_init()
 {
-    // I2C 400kHz
-    i2c_lsm.frequency(400000);
+    // I2C 400kHz, register access through the transaction queue
+    i2c_lsm.frequency(I2C_BUS_HZ);
+#if DEVICE_I2C_ASYNCH
+    i2c_lsm.set_dma_usage(DMA_USAGE_OPPORTUNISTIC);
+#endif
+    i2c_txn_init(bus_start, bus_defer);
 
     // Small delay to allow power-up to settle
     ThisThread::sleep_for(10ms);
@@ -75,11 +198,18 @@ bool lsm6dsl_init()
     }
 
     // Configure accelerometer CTRL1_XL:
-    // ODR_XL[3:0] = 0b0011 => 52 Hz
+    // ODR_XL[3:0] = 0b0011 => 52 Hz (legacy), or ACQ_ODR_HZ when oversampling
     // FS_XL[1:0]  = 0b00   => ±2 g
-    // BW0_XL / LPF1_BW_SEL left at 0
-    // => 0b0011 0000 = 0x30
-    if (!write_reg(REG_CTRL1_XL, 0x30)) {
+    // Legacy:      BW0_XL / LPF1_BW_SEL left at 0 => 0b0011 0000 = 0x30
+    // Oversampled: LPF1 at ODR/4 and 400 Hz analog anti-alias filter,
+    //              e.g. 208 Hz => 0b0101 0011 = 0x53
+    uint8_t ctrl1_xl = 0x30;
+    if (ACQ_OVERSAMPLE_FACTOR > 1) {
+        ctrl1_xl = static_cast<uint8_t>((odr_code(ACQ_ODR_HZ) << 4) |
+                                        CTRL1_XL_LPF1_BW_SEL |
+                                        CTRL1_XL_BW0_XL);
+    }
+    if (!write_reg(REG_CTRL1_XL, ctrl1_xl)) {
         printf("[LSM6DSL] Failed to write CTRL1_XL\r\n");
         return false;
     }
@@ -93,6 +223,32 @@ bool lsm6dsl_init()
         return false;
     }
 
+    // Timestamp counter at 25 µs resolution, restarted from 0
+    if (!write_reg(REG_WAKE_UP_DUR, 0x10) ||
+        !write_reg(REG_CTRL10_C, 0x20) ||
+        !write_reg(REG_TIMESTAMP2, 0xAA)) {
+        printf("[LSM6DSL] Failed to enable timestamp\r\n");
+        return false;
+    }
+    g_ts_last_raw = 0;
+    g_ts_us       = 0;
+
+    if (ACQ_OVERSAMPLE_FACTOR > 1) {
+        // Flush the FIFO by passing through bypass mode, then store only
+        // accelerometer data (DEC_FIFO_XL = 001: no decimation, gyro off)
+        // and run it in continuous mode at the accelerometer ODR.
+        // With a single data set the FIFO pattern is simply X, Y, Z.
+        const uint8_t fifo_ctrl5 = static_cast<uint8_t>((odr_code(ACQ_ODR_HZ) << 3) |
+                                                        FIFO_MODE_CONTINUOUS);
+        if (!write_reg(REG_FIFO_CTRL5, FIFO_MODE_BYPASS) ||
+            !write_reg(REG_FIFO_CTRL3, 0x01) ||
+            !write_reg(REG_FIFO_CTRL5, fifo_ctrl5)) {
+            printf("[LSM6DSL] Failed to configure FIFO\r\n");
+            return false;
+        }
+        printf("[LSM6DSL] FIFO continuous @ %.0f Hz\r\n", ACQ_ODR_HZ);
+    }
+
     printf("[LSM6DSL] Init done\r\n");
     return true;
 }
@@ -117,3 +273,236 @@ bool lsm6dsl_read_accel(float &ax_g, float &ay_g, float &az_g)
 
     return true;
 }
+
+// Unwrap the 24-bit counter into a 32-bit µs time base
+static uint32_t unwrap_timestamp(const uint8_t raw[3])
+{
+    const uint32_t ts_raw = static_cast<uint32_t>(raw[2]) << 16 |
+                            static_cast<uint32_t>(raw[1]) << 8 |
+                            raw[0];
+    g_ts_us += ((ts_raw - g_ts_last_raw) & TIMESTAMP_MASK) * TIMESTAMP_US_PER_LSB;
+    g_ts_last_raw = ts_raw;
+    return g_ts_us;
+}
+
+bool lsm6dsl_read_timestamp(uint32_t &ts_us)
+{
+    uint8_t raw[3] = {0};
+
+    if (!read_regs(REG_TIMESTAMP0, raw, sizeof(raw))) {
+        return false;
+    }
+
+    ts_us = unwrap_timestamp(raw);
+    return true;
+}
+
+bool lsm6dsl_read_accel_timestamped(float &ax_g, float &ay_g, float &az_g, uint32_t &ts_us)
+{
+    // The data and timestamp registers are not contiguous (0x28..0x2D vs
+    // 0x40..0x42; the span between them holds FIFO / embedded-function
+    // status with read side effects), so they take two transactions. Move
+    // the timestamp back by one read duration to the end of the data read.
+    if (!lsm6dsl_read_accel(ax_g, ay_g, az_g) || !lsm6dsl_read_timestamp(ts_us)) {
+        return false;
+    }
+    ts_us -= ACCEL_READ_US;
+    return true;
+}
+
+// FIFO_STATUS1..4 -> unread word count; *skip = words to discard so the
+// next read starts on an X word (a previous read stopped mid-set)
+static size_t parse_fifo_status(const uint8_t status[4], size_t &skip)
+{
+    const size_t words = (static_cast<size_t>(status[1] & 0x07) << 8) | status[0];
+    const unsigned pattern = (static_cast<unsigned>(status[3] & 0x03) << 8) | status[2];
+
+    skip = (pattern != 0 && pattern < 3) ? 3 - pattern : 0;
+    return words;
+}
+
+// Little-endian byte pairs -> int16 (in place; element i only reads bytes 2i, 2i+1)
+static void unpack_fifo_words(int16_t *xyz_raw, size_t words)
+{
+    const uint8_t *bytes = reinterpret_cast<const uint8_t *>(xyz_raw);
+    for (size_t i = 0; i < words; ++i) {
+        const uint8_t lo = bytes[2 * i];
+        const uint8_t hi = bytes[2 * i + 1];
+        xyz_raw[i] = static_cast<int16_t>(static_cast<int16_t>(hi) << 8 | lo);
+    }
+}
+
+// ------------------------------------------------------------
+// Asynchronous FIFO poll
+// ------------------------------------------------------------
+//
+// lsm6dsl_fifo_poll_start() queues the timestamp and FIFO status reads.
+// The status callback then queues the re-alignment discard (if any) and a
+// data burst sized from the status, straight into the caller's buffer.
+
+enum FifoPollState {
+    FIFO_POLL_IDLE,
+    FIFO_POLL_RUNNING,
+    FIFO_POLL_DONE
+};
+
+struct FifoPoll {
+    FifoPollState state;
+    bool     ok;
+    bool     finished;   // result known, waiting for pending transactions
+    size_t   pending;    // poll transactions queued or on the bus
+    int16_t *xyz_raw;
+    size_t   max_sets;
+    size_t   sets;
+    size_t   available;
+    uint32_t ts_us;
+    uint8_t  ts_raw[3];
+    uint8_t  status[4];
+    uint8_t  discard[4];
+};
+
+static FifoPoll g_poll = {};
+
+// Record the poll result. It only becomes DONE once none of its transactions
+// is still queued or on the bus: they write into g_poll (and the caller's
+// buffer), which the next lsm6dsl_fifo_poll_start() reuses.
+static void fifo_poll_finish(bool ok)
+{
+    g_poll.ok = g_poll.ok && ok;
+    if (!g_poll.ok) {
+        g_poll.sets = 0;
+    }
+    g_poll.finished = true;
+    if (g_poll.pending == 0) {
+        g_poll.state = FIFO_POLL_DONE;
+    }
+}
+
+static bool poll_read(uint8_t reg, uint8_t *buf, size_t len, i2c_txn_done_fn done)
+{
+    if (!i2c_txn_read_regs(LSM6DSL_I2C_ADDR_WRITE, reg, buf, len, done, nullptr)) {
+        return false;
+    }
+    ++g_poll.pending;
+    return true;
+}
+
+// Start of every poll callback; true if the poll had already finished and
+// this was one of the transactions it was waiting for
+static bool poll_txn_done()
+{
+    --g_poll.pending;
+    if (g_poll.finished) {
+        fifo_poll_finish(g_poll.ok);
+        return true;
+    }
+    return false;
+}
+
+static void on_poll_timestamp(bool ok, void *)
+{
+    if (ok) {
+        g_poll.ts_us = unwrap_timestamp(g_poll.ts_raw);
+    } else {
+        g_poll.ok = false;
+    }
+    poll_txn_done();
+}
+
+static void on_poll_discard(bool ok, void *)
+{
+    if (!ok) {
+        g_poll.ok = false;
+    }
+    poll_txn_done();
+}
+
+static void on_poll_data(bool ok, void *)
+{
+    if (poll_txn_done()) {
+        return;
+    }
+    if (ok) {
+        unpack_fifo_words(g_poll.xyz_raw, g_poll.sets * 3);
+    }
+    fifo_poll_finish(ok);
+}
+
+static void on_poll_status(bool ok, void *)
+{
+    if (poll_txn_done()) {
+        return;
+    }
+    if (!ok || !g_poll.ok) {
+        fifo_poll_finish(false);
+        return;
+    }
+
+    size_t skip = 0;
+    size_t words = parse_fifo_status(g_poll.status, skip);
+    g_poll.available = words / 3;
+
+    if (skip > 0) {
+        if (words < skip || !poll_read(REG_FIFO_DATA_OUT_L, g_poll.discard, 2 * skip, on_poll_discard)) {
+            fifo_poll_finish(false);
+            return;
+        }
+        words -= skip;
+    }
+
+    size_t sets = words / 3;
+    if (sets > g_poll.max_sets) {
+        sets = g_poll.max_sets;
+    }
+    g_poll.sets = sets;
+    if (sets == 0) {
+        fifo_poll_finish(true);
+        return;
+    }
+
+    if (!poll_read(REG_FIFO_DATA_OUT_L, reinterpret_cast<uint8_t *>(g_poll.xyz_raw), sets * 6,
+                   on_poll_data)) {
+        // An already queued discard still completes before the poll is DONE
+        fifo_poll_finish(false);
+    }
+}
+
+bool lsm6dsl_fifo_poll_start(int16_t *xyz_raw, size_t max_sets)
+{
+    if (g_poll.state == FIFO_POLL_RUNNING) {
+        return false;
+    }
+
+    g_poll = FifoPoll{};
+    g_poll.state    = FIFO_POLL_RUNNING;
+    g_poll.ok       = true;
+    g_poll.xyz_raw  = xyz_raw;
+    g_poll.max_sets = max_sets;
+
+    if (!poll_read(REG_TIMESTAMP0, g_poll.ts_raw, sizeof(g_poll.ts_raw), on_poll_timestamp)) {
+        g_poll.state = FIFO_POLL_IDLE;
+        return false;
+    }
+    if (!poll_read(REG_FIFO_STATUS1, g_poll.status, sizeof(g_poll.status), on_poll_status)) {
+        // Failed, but the poll stays RUNNING until the queued timestamp
+        // read has completed (on_poll_timestamp finishes it)
+        fifo_poll_finish(false);
+    }
+    return true;
+}
+
+bool lsm6dsl_fifo_poll_done(bool &ok, uint32_t &ts_us, size_t &sets_read, size_t &available_sets)
+{
+    i2c_txn_dispatch();
+
+    if (g_poll.state != FIFO_POLL_DONE) {
+        return false;
+    }
+
+    ok             = g_poll.ok;
+    ts_us          = g_poll.ts_us;
+    sets_read      = g_poll.sets;
+    available_sets = g_poll.available;
+    g_poll.state   = FIFO_POLL_IDLE;
+    return true;
+}
@@ -2,9 +2,21 @@
 
 #include "config.h"
 #include "lsm6dsl_driver.h"
-#include "fft_utils.h"
+#include "window_accumulator.h"
+#include "window_features.h"
 #include "detector.h"
+#include "window_history.h"
+#include "publish_filter.h"
+#include "decimator.h"
+#include "sample_timing.h"
+#include "profiling.h"
 #include "ble_service.h"
+#ifdef RTES_BENCH
+#include "bench.h"
+#endif
+#ifdef RTES_KERNEL_CHECK
+#include "kernel_check.h"
+#endif
 
 using namespace std::chrono;
 
@@ -15,16 +27,40 @@ static DigitalOut led_dysk(LED2);   // PB14 - indicates dyskinesia intensity
 // Serial output (for debugging)
 static BufferedSerial pc(USBTX, USBRX, 115200);
 
-// Sample buffers
-static float g_ax[SAMPLES_PER_WINDOW];
-static float g_ay[SAMPLES_PER_WINDOW];
-static float g_az[SAMPLES_PER_WINDOW];
-
-static float g_mag[SAMPLES_PER_WINDOW];
-static float g_spectrum[FFT_LENGTH / 2];
+// Streaming window state: every sample is folded in as it arrives, so no
+// raw samples are buffered and the window close is near-constant time
+static WindowAccumulator g_acc;
+static float g_spectrum[ACC_SPECTRUM_BINS];
 
 static std::size_t g_sample_index = 0;
 
+// Feature history of the last HISTORY_WINDOWS windows (trends), level
+// hysteresis per band and the notification rate limit
+static WindowHistory   g_history;
+static LevelHysteresis g_tremor_hyst;
+static LevelHysteresis g_dysk_hyst;
+static PublishGate     g_publish_gate;
+
+// Oversampled acquisition: two raw FIFO batches (interleaved XYZ), one
+// decimator per axis and the decimated output of one batch. The next FIFO
+// poll transfers into one buffer while the other is being decimated.
+static std::int16_t   g_fifo_raw[2][ACQ_FIFO_BATCH_SETS * 3];
+static std::size_t    g_fifo_buf         = 0;      // buffer of the poll in flight
+static bool           g_fifo_poll_active = false;
+static DecimatorState g_decim[3];
+static std::int16_t   g_decim_out[3][ACQ_FIFO_BATCH_SETS / DECIM_FACTOR + 1];
+
+// Sets re-created in front of the decimator after a FIFO overrun,
+// the last set of the previous poll (interpolation anchor) and the
+// number of sets drained by the previous poll
+static std::int16_t g_fifo_fill[ACQ_FIFO_BATCH_SETS * 3];
+static std::int16_t g_fifo_last[3]     = {0, 0, 0};
+static bool         g_fifo_have_last   = false;
+static std::size_t  g_fifo_drained_last = 0;
+
+// Free-running MCU time base (window timing, sample scheduling)
+static Timer g_uptime;
+
 // Simple wrapper for formatted serial output
 static void pc_printf(const char *fmt, ...)
 {
@@ -70,26 +106,64 @@ static void update_leds(const DetectionResult &res)
     }
 }
 
-// Process one complete 3s window: spectrum -> detection -> LED/BLE/Teleplot
+// Trends over the feature history (serial + Teleplot), every
+// TREND_REPORT_WINDOWS windows. Slopes are per minute.
+static void report_trends()
+{
+    const float per_min = 60.0f / WINDOW_SECONDS;
+    const FeatureTrend tremor  = history_trend(g_history, FEAT_TREMOR_RMS_G);
+    const FeatureTrend dysk    = history_trend(g_history, FEAT_DYSK_RMS_G);
+    const FeatureTrend cadence = history_trend(g_history, FEAT_CADENCE_HZ);
+
+    pc_printf("[TREND] windows=%u, tremor ema=%.4f min=%.4f max=%.4f slope=%+.4f g/min, "
+              "dysk ema=%.4f min=%.4f max=%.4f slope=%+.4f g/min, cadence ema=%.2f Hz, "
+              "published=%lu, refreshed=%lu, held=%lu\r\n",
+              static_cast<unsigned>(history_count(g_history)),
+              tremor.ema, tremor.min, tremor.max, tremor.slope * per_min,
+              dysk.ema, dysk.min, dysk.max, dysk.slope * per_min,
+              cadence.ema,
+              static_cast<unsigned long>(g_publish_gate.sent),
+              static_cast<unsigned long>(g_publish_gate.refreshed),
+              static_cast<unsigned long>(g_publish_gate.held));
+
+    pc_printf(">tremor_ema:%.4f\r\n",   tremor.ema);
+    pc_printf(">tremor_slope:%.4f\r\n", tremor.slope * per_min);
+    pc_printf(">dysk_ema:%.4f\r\n",     dysk.ema);
+    pc_printf(">dysk_slope:%.4f\r\n",   dysk.slope * per_min);
+}
+
+// Process one complete 3s window: spectrum -> features -> classifier -> LED/BLE/Teleplot
 // This function runs the full per-window pipeline and publishes results.
 static void process_window()
 {
-    // 1) Compute magnitude
-    compute_magnitude(g_ax, g_ay, g_az, SAMPLES_PER_WINDOW, g_mag);
+    const std::uint32_t t_close = prof_now();
 
-    // 2) Estimate step count
-    const std::uint16_t step_count = estimate_step_count(g_mag, SAMPLES_PER_WINDOW);
+    // 1) Close the accumulator: spectrum, step count, variance of |a|
+    //    (magnitude, Welford stats, step state and DFT sums were updated per sample)
+    std::uint16_t step_count = 0;
+    float mag_variance = 0.0f;
+    window_acc_finish(g_acc, g_spectrum, step_count, mag_variance);
 
-    // 3) Compute DFT magnitude spectrum
-    compute_dft_magnitude(g_mag, SAMPLES_PER_WINDOW, g_spectrum, FFT_LENGTH);
-
-    // 4) Band energy + FOG detection
-    DetectionResult res = detect_conditions(
+    // 2) Feature vector (band powers, dominant frequency, entropy, cadence, variance)
+    const FeatureVector features = build_features(
         g_spectrum,
-        FFT_LENGTH / 2,
-        step_count
+        ACC_SPECTRUM_BINS,
+        step_count,
+        mag_variance
     );
 
+    // 3) Classifier stage + FOG detection
+    DetectionResult res = detect_conditions(features);
+
+    // 4) History (O(1) trend update) and level hysteresis
+    history_push(g_history, features);
+    res.tremor_level = level_hysteresis_update(g_tremor_hyst, res.tremor_level, g_history, FEAT_TREMOR_RMS_G,
+                                               TREMOR_LEVEL1_RMS_G, TREMOR_LEVEL2_RMS_G, TREMOR_LEVEL3_RMS_G);
+    res.dyskinesia_level = level_hysteresis_update(g_dysk_hyst, res.dyskinesia_level, g_history, FEAT_DYSK_RMS_G,
+                                                   DYSK_LEVEL1_RMS_G, DYSK_LEVEL2_RMS_G, DYSK_LEVEL3_RMS_G);
+
+    timing_note_window_close(prof_now() - t_close);
+
     // Print a line of debug info so values are readable over serial
     pc_printf("[WIN] steps=%u, tremor_rms=%.4f g, dysk_rms=%.4f g, tremor_lvl=%u, dysk_lvl=%u, fog=%u\r\n",
               step_count,
@@ -107,11 +181,201 @@ static void process_window()
     pc_printf(">dysk_lvl:%u\r\n",       res.dyskinesia_level);
     pc_printf(">fog:%u\r\n",            res.fog_level);
 
+    // Feature log, same columns as tools/export_classifier.py training CSV
+    pc_printf("[FEAT] %.5f,%.5f,%.5f,%.3f,%.4f,%.3f,%.6f\r\n",
+              features.v[FEAT_TREMOR_RMS_G],
+              features.v[FEAT_DYSK_RMS_G],
+              features.v[FEAT_GAIT_RMS_G],
+              features.v[FEAT_DOMINANT_HZ],
+              features.v[FEAT_SPECTRAL_ENTROPY],
+              features.v[FEAT_CADENCE_HZ],
+              features.v[FEAT_MAG_VARIANCE_G2]);
+
     // 5) Update LEDs
     update_leds(res);
 
-    // 6) Update the three BLE characteristics
-    ble_service_update(res.tremor_level, res.dyskinesia_level, res.fog_level);
+    // 6) Update the three BLE characteristics, at most once per
+    //    PUBLISH_MIN_INTERVAL_WINDOWS unless FOG changed; re-send everything
+    //    every PUBLISH_REFRESH_WINDOWS windows without a change
+    const PublishedLevels levels = {res.tremor_level, res.dyskinesia_level, res.fog_level};
+    const PublishAction action = publish_gate_update(g_publish_gate, g_history, levels);
+    if (action == PUBLISH_CHANGE) {
+        ble_service_update(levels.tremor_level, levels.dyskinesia_level, levels.fog_level);
+    } else if (action == PUBLISH_REFRESH) {
+        ble_service_refresh();
+    }
+
+    if (g_history.pushed % TREND_REPORT_WINDOWS == 0) {
+        report_trends();
+    }
+}
+
+static std::uint16_t saturate_u16(std::uint32_t v)
+{
+    return static_cast<std::uint16_t>(v > 0xFFFFu ? 0xFFFFu : v);
+}
+
+// Publish sampling health counters (serial, Teleplot, BLE)
+static void report_timing()
+{
+    const TimingStats &st = timing_stats();
+
+    pc_printf("[TIM] dropped=%lu, filled=%lu, resampled=%lu, late_win=%lu, deadline_miss=%lu, "
+              "max_jitter=%lu us, proc=%lu us (max %lu us), sample_max=%lu cyc, close=%lu cyc (max %lu cyc)\r\n",
+              static_cast<unsigned long>(st.dropped_samples),
+              static_cast<unsigned long>(st.filled_samples),
+              static_cast<unsigned long>(st.resampled_samples),
+              static_cast<unsigned long>(st.late_windows),
+              static_cast<unsigned long>(st.deadline_misses),
+              static_cast<unsigned long>(st.max_jitter_us),
+              static_cast<unsigned long>(st.last_process_us),
+              static_cast<unsigned long>(st.max_process_us),
+              static_cast<unsigned long>(st.max_sample_ticks),
+              static_cast<unsigned long>(st.last_close_ticks),
+              static_cast<unsigned long>(st.max_close_ticks));
+
+    pc_printf(">dropped:%lu\r\n",       static_cast<unsigned long>(st.dropped_samples));
+    pc_printf(">late_win:%lu\r\n",      static_cast<unsigned long>(st.late_windows));
+    pc_printf(">deadline_miss:%lu\r\n", static_cast<unsigned long>(st.deadline_misses));
+    pc_printf(">proc_us:%lu\r\n",       static_cast<unsigned long>(st.last_process_us));
+    pc_printf(">sample_max_cyc:%lu\r\n", static_cast<unsigned long>(st.max_sample_ticks));
+    pc_printf(">close_cyc:%lu\r\n",      static_cast<unsigned long>(st.last_close_ticks));
+
+    ble_service_update_health(saturate_u16(st.dropped_samples),
+                              saturate_u16(st.resampled_samples),
+                              saturate_u16(st.late_windows),
+                              saturate_u16(st.deadline_misses));
+}
+
+// Fold one analysis-rate sample into the window; runs the pipeline when full
+static void push_sample(float ax, float ay, float az)
+{
+    if (g_sample_index < SAMPLES_PER_WINDOW) {
+        const std::uint32_t t0 = prof_now();
+        window_acc_push(g_acc, ax, ay, az);
+        timing_note_sample_cost(prof_now() - t0);
+        ++g_sample_index;
+    }
+
+    if (g_sample_index >= SAMPLES_PER_WINDOW) {
+        const auto t_close = g_uptime.elapsed_time();
+        process_window();
+        const auto t_done = g_uptime.elapsed_time();
+        g_sample_index = 0;
+        window_acc_reset(g_acc);
+
+        timing_window_done(static_cast<std::uint32_t>(t_close.count()),
+                           static_cast<std::uint32_t>((t_done - t_close).count()));
+        report_timing();
+    }
+}
+
+// Feed n interleaved raw XYZ sets through the decimators into the window
+static void decimate_sets(const std::int16_t *xyz_raw, std::size_t sets)
+{
+    std::size_t produced = 0;
+    for (std::size_t a = 0; a < 3; ++a) {
+        // All three decimators share the same phase, so they produce
+        // the same number of outputs for the same input
+        produced = decimator_process(g_decim[a], &xyz_raw[a], sets, 3, g_decim_out[a], 1);
+    }
+
+    for (std::size_t i = 0; i < produced; ++i) {
+        push_sample(g_decim_out[0][i] * ACC_G_PER_LSB,
+                    g_decim_out[1][i] * ACC_G_PER_LSB,
+                    g_decim_out[2][i] * ACC_G_PER_LSB);
+    }
+}
+
+// Bridge sets lost to a FIFO overrun: in continuous mode the oldest data is
+// overwritten, so the gap sits between the last set of the previous poll and
+// the first set read now. Interpolate up to one batch worth of sets across it
+// so the decimator keeps seeing a uniform grid.
+static void fill_fifo_gap(std::size_t lost_sets, const std::int16_t *first_set)
+{
+    if (!g_fifo_have_last || lost_sets == 0) {
+        return;
+    }
+
+    const std::size_t n = (lost_sets < ACQ_FIFO_BATCH_SETS) ? lost_sets : ACQ_FIFO_BATCH_SETS;
+    for (std::size_t i = 0; i < n; ++i) {
+        const float w = static_cast<float>(i + 1) / static_cast<float>(lost_sets + 1);
+        for (std::size_t a = 0; a < 3; ++a) {
+            const float v = g_fifo_last[a] + w * static_cast<float>(first_set[a] - g_fifo_last[a]);
+            g_fifo_fill[3 * i + a] = static_cast<std::int16_t>(v);
+        }
+    }
+
+    decimate_sets(g_fifo_fill, n);
+    timing_note_fifo_fill(n);
+}
+
+// Queue a non-blocking FIFO poll (timestamp, status, one batch) into the free buffer
+static void start_fifo_poll()
+{
+    g_fifo_poll_active = lsm6dsl_fifo_poll_start(g_fifo_raw[g_fifo_buf], ACQ_FIFO_BATCH_SETS);
+}
+
+// Collect a finished FIFO poll, decimate each axis to SAMPLE_FREQUENCY_HZ and
+// feed the result into the window accumulator. If a full batch came back the
+// FIFO holds more, so the next poll is queued first and its transfer runs
+// while this batch (and possibly process_window) is computed; a late poll
+// catches up this way. The sensor timestamp of each poll is used to detect
+// sets lost to FIFO overrun.
+static void acquire_fifo()
+{
+    bool ok = false;
+    std::uint32_t ts_us = 0;
+    std::size_t sets = 0;
+    std::size_t available = 0;
+
+    if (!g_fifo_poll_active || !lsm6dsl_fifo_poll_done(ok, ts_us, sets, available)) {
+        return;
+    }
+    g_fifo_poll_active = false;
+    if (!ok) {
+        return;
+    }
+
+    const std::int16_t *raw = g_fifo_raw[g_fifo_buf];
+    g_fifo_buf ^= 1;
+    if (sets == ACQ_FIFO_BATCH_SETS) {
+        start_fifo_poll();
+    }
+
+    const std::size_t lost = timing_check_fifo(ts_us, available, g_fifo_drained_last);
+    g_fifo_drained_last = sets;
+    if (sets == 0) {
+        return;
+    }
+    fill_fifo_gap(lost, raw);
+
+    decimate_sets(raw, sets);
+
+    g_fifo_last[0] = raw[3 * (sets - 1) + 0];
+    g_fifo_last[1] = raw[3 * (sets - 1) + 1];
+    g_fifo_last[2] = raw[3 * (sets - 1) + 2];
+    g_fifo_have_last = true;
+}
+
+// Legacy mode: read one sample with its sensor timestamp and place it on the
+// uniform grid (read failures are counted and bridged by the resampler)
+static void acquire_direct()
+{
+    float ax = 0.0f, ay = 0.0f, az = 0.0f;
+    std::uint32_t ts_us = 0;
+
+    if (!lsm6dsl_read_accel_timestamped(ax, ay, az, ts_us)) {
+        timing_note_read_failure();
+        return;
+    }
+
+    // A 4-slot burst bridges up to 3 consecutive failed reads
+    TimedSample out[4];
+    const std::size_t n = timing_push_sample(ts_us, ax, ay, az, out, 4);
+    for (std::size_t i = 0; i < n; ++i) {
+        push_sample(out[i].ax, out[i].ay, out[i].az);
+    }
 }
 
 int main()
@@ -120,11 +384,29 @@ int main()
     pc_printf("\r\nRTES F25 - Shake, Rattle, Roll and Freeze\r\n");
     pc_printf("Board: B-L475E-IOT01A, IMU: LSM6DSL, fs=%.1f Hz, window=%.1f s\r\n",
               SAMPLE_FREQUENCY_HZ, WINDOW_SECONDS);
+    if (ACQ_OVERSAMPLE_FACTOR > 1) {
+        pc_printf("Acquisition: FIFO @ %.0f Hz, %u-tap polyphase decimation by %u\r\n",
+                  ACQ_ODR_HZ,
+                  static_cast<unsigned>(DECIM_TAPS),
+                  static_cast<unsigned>(DECIM_FACTOR));
+    }
 
     // Initial LED states
     led_tremor = 0;
     led_dysk   = 0;
 
+#ifdef RTES_BENCH
+    // Benchmark build: report kernel throughput before starting the pipeline
+    run_benchmarks(pc_printf);
+#endif
+
+#ifdef RTES_KERNEL_CHECK
+    // Check build: compare optimised kernels with the reference ones on target
+    if (!run_kernel_check(pc_printf)) {
+        pc_printf("[ERROR] kernel check failed, see [CHECK] lines above\r\n");
+    }
+#endif
+
     // Initialize IMU
     bool imu_ok = lsm6dsl_init();
     if (!imu_ok) {
@@ -134,40 +416,50 @@ int main()
     // Initialize BLE
     ble_service_init();
 
-    // Sampling timer
-    Timer sample_timer;
-    sample_timer.start();
-    auto last_sample_time = sample_timer.elapsed_time();
-    const microseconds sample_period_us(
-        static_cast<int>(1000000.0f / SAMPLE_FREQUENCY_HZ)
+    for (std::size_t a = 0; a < 3; ++a) {
+        decimator_reset(g_decim[a]);
+    }
+
+    timing_reset();
+    prof_init();
+    window_acc_reset(g_acc);
+    history_reset(g_history);
+    level_hysteresis_reset(g_tremor_hyst);
+    level_hysteresis_reset(g_dysk_hyst);
+    publish_gate_reset(g_publish_gate);
+
+    // Sampling timer. The sample deadline is kept in nanoseconds so the
+    // 1/52 s period (19230.77 µs) does not drift by truncation.
+    g_uptime.start();
+    nanoseconds next_sample_time = g_uptime.elapsed_time();
+    const nanoseconds sample_period_ns(
+        static_cast<long long>(1.0e9 / SAMPLE_FREQUENCY_HZ)
+    );
+    auto last_poll_time = g_uptime.elapsed_time();
+    // Oversampled mode: poll the FIFO roughly once per batch
+    const microseconds fifo_poll_period_us(
+        static_cast<int>(1000000.0f * ACQ_FIFO_BATCH_SETS / ACQ_ODR_HZ)
     );
 
     while (true) {
         // 1) Timed sampling
-        auto now = sample_timer.elapsed_time();
-        if (now - last_sample_time >= sample_period_us) {
-            last_sample_time += sample_period_us;
-
-            float ax = 0.0f, ay = 0.0f, az = 0.0f;
-            bool ok = lsm6dsl_read_accel(ax, ay, az);
-
-            if (ok && g_sample_index < SAMPLES_PER_WINDOW) {
-                g_ax[g_sample_index] = ax;
-                g_ay[g_sample_index] = ay;
-                g_az[g_sample_index] = az;
-                ++g_sample_index;
-            }
-
-            if (g_sample_index >= SAMPLES_PER_WINDOW) {
-                process_window();
-                g_sample_index = 0;
+        auto now = g_uptime.elapsed_time();
+        if (ACQ_OVERSAMPLE_FACTOR > 1) {
+            acquire_fifo();
+            if (!g_fifo_poll_active && now - last_poll_time >= fifo_poll_period_us) {
+                last_poll_time = now;
+                start_fifo_poll();
             }
+        } else if (now >= next_sample_time) {
+            next_sample_time += sample_period_ns;
+            acquire_direct();
         }
 
         // 2) Let BLE process stack events
         ble_service_process();
 
-        // 3) Short sleep to reduce busy-waiting
+        // 3) Short sleep to reduce busy-waiting (FIFO transfers continue
+        //    in the background and are collected on the next pass)
         ThisThread::sleep_for(2ms);
     }
 }
@@ -0,0 +1,96 @@
+#include "publish_filter.h"
+
+void level_hysteresis_reset(LevelHysteresis &h)
+{
+    h.level = 0;
+}
+
+std::uint8_t level_hysteresis_update(LevelHysteresis &h,
+                                     std::uint8_t raw_level,
+                                     const WindowHistory &hist,
+                                     FeatureIndex band,
+                                     float l1, float l2, float l3)
+{
+    if (raw_level > 3) {
+        raw_level = 3;
+    }
+    if (raw_level == h.level) {
+        return h.level;
+    }
+
+    // Threshold between the current and the new level: going up, the one
+    // that reaches raw_level; going down, the one raw_level stays under
+    const float thresholds[3] = {l1, l2, l3};
+    const bool  up = raw_level > h.level;
+    const float threshold = up ? thresholds[raw_level - 1] : thresholds[raw_level];
+
+    // Clear change: the smoothed band RMS is past the dead band
+    const float ema = history_trend(hist, band).ema;
+    bool accept = up ? ema >= threshold * (1.0f + LEVEL_HYSTERESIS_FRAC)
+                     : ema <= threshold * (1.0f - LEVEL_HYSTERESIS_FRAC);
+
+    // Inside the dead band: accept once the new level held for the last
+    // LEVEL_CONFIRM_WINDOWS windows of the ring. A classifier decision the
+    // band RMS does not back up is held until it does.
+    if (!accept && history_count(hist) >= LEVEL_CONFIRM_WINDOWS) {
+        accept = true;
+        for (std::size_t age = 0; age < LEVEL_CONFIRM_WINDOWS; ++age) {
+            const float rms = history_at(hist, age).v[band];
+            if (up ? rms < threshold : rms >= threshold) {
+                accept = false;
+                break;
+            }
+        }
+    }
+
+    if (accept) {
+        h.level = raw_level;
+    }
+    return h.level;
+}
+
+void publish_gate_reset(PublishGate &g)
+{
+    g.published   = PublishedLevels{0, 0, 0};
+    g.pending     = false;
+    // As if the last publish was a full interval before the first window,
+    // so the first change goes out at once (wraps; only differences are used)
+    g.last_window = 0u - PUBLISH_MIN_INTERVAL_WINDOWS;
+    g.sent        = 0;
+    g.refreshed   = 0;
+    g.held        = 0;
+}
+
+PublishAction publish_gate_update(PublishGate &g,
+                                  const WindowHistory &hist,
+                                  const PublishedLevels &levels)
+{
+    const std::uint32_t since = hist.pushed - g.last_window;
+
+    const bool changed = levels.tremor_level     != g.published.tremor_level ||
+                         levels.dyskinesia_level != g.published.dyskinesia_level ||
+                         levels.fog_level        != g.published.fog_level;
+    if (!changed) {
+        // A held change that reverted on its own is dropped
+        g.pending = false;
+        if (since < PUBLISH_REFRESH_WINDOWS) {
+            return PUBLISH_NONE;
+        }
+        g.last_window = hist.pushed;
+        ++g.refreshed;
+        return PUBLISH_REFRESH;
+    }
+
+    const bool urgent = (levels.fog_level != g.published.fog_level);
+    if (!urgent && since < PUBLISH_MIN_INTERVAL_WINDOWS) {
+        g.pending = true;
+        ++g.held;
+        return PUBLISH_NONE;
+    }
+
+    g.published   = levels;
+    g.pending     = false;
+    g.last_window = hist.pushed;
+    ++g.sent;
+    return PUBLISH_CHANGE;
+}
@@ -0,0 +1,234 @@
+#include "sample_timing.h"
+
+#include <cstdint>
+
+static TimingStats g_stats{};
+
+// ------------------------------------------------------------
+// Legacy-mode resampler state
+// ------------------------------------------------------------
+
+// Grid slot n sits at g_grid_t0_us + n * SAMPLE_PERIOD_US (sensor time)
+static bool          g_grid_primed = false;
+static std::uint32_t g_grid_t0_us  = 0;
+static std::uint32_t g_grid_n      = 0;
+
+// Previous accepted sample (interpolation anchor)
+static std::uint32_t g_prev_ts_us = 0;
+static float         g_prev[3]    = {0.0f, 0.0f, 0.0f};
+
+// ------------------------------------------------------------
+// FIFO-mode tracking state
+// ------------------------------------------------------------
+
+static bool          g_fifo_primed     = false;
+static std::uint32_t g_fifo_prev_ts    = 0;
+static std::size_t   g_fifo_prev_avail = 0;
+static float         g_fifo_carry      = 0.0f;  // fractional sets not yet accounted
+
+// Window bookkeeping
+static bool          g_window_primed  = false;
+static std::uint32_t g_window_prev_us = 0;
+
+void timing_reset()
+{
+    g_stats = TimingStats{};
+    g_grid_primed   = false;
+    g_fifo_primed   = false;
+    g_fifo_carry    = 0.0f;
+    g_window_primed = false;
+}
+
+const TimingStats &timing_stats()
+{
+    return g_stats;
+}
+
+static std::uint32_t grid_time_us(std::uint32_t n)
+{
+    // Exact slot time without accumulating the truncated 19230 µs period
+    return g_grid_t0_us + static_cast<std::uint32_t>(
+        static_cast<std::uint64_t>(n) * 1000000ULL * 1000ULL /
+        static_cast<std::uint64_t>(SAMPLE_FREQUENCY_HZ * 1000.0f));
+}
+
+// Jitter against the nearest grid slot at or after slot n. A sample that
+// arrives about k periods late because k reads were missed sits near a later
+// slot; those missed slots are counted as dropped / filled, not as jitter.
+static std::int32_t slot_jitter_us(std::uint32_t ts_us, std::uint32_t n)
+{
+    const std::int32_t jitter = static_cast<std::int32_t>(ts_us - grid_time_us(n));
+    if (static_cast<float>(jitter) <= 0.5f * SAMPLE_PERIOD_US) {
+        return jitter;
+    }
+    const std::uint32_t k = static_cast<std::uint32_t>(static_cast<float>(jitter) / SAMPLE_PERIOD_US + 0.5f);
+    return static_cast<std::int32_t>(ts_us - grid_time_us(n + k));
+}
+
+static void note_jitter(std::int32_t jitter_us)
+{
+    const std::uint32_t mag = static_cast<std::uint32_t>(jitter_us < 0 ? -jitter_us : jitter_us);
+    if (mag > g_stats.max_jitter_us) {
+        g_stats.max_jitter_us = mag;
+    }
+}
+
+void timing_note_read_failure()
+{
+    ++g_stats.dropped_samples;
+}
+
+std::size_t timing_push_sample(std::uint32_t ts_us,
+                               float ax, float ay, float az,
+                               TimedSample *out,
+                               std::size_t max_out)
+{
+    if (max_out == 0) {
+        return 0;
+    }
+
+    if (!g_grid_primed) {
+        // First sample anchors the grid
+        g_grid_primed = true;
+        g_grid_t0_us  = ts_us;
+        g_grid_n      = 1;
+        g_prev_ts_us  = ts_us;
+        g_prev[0] = ax;
+        g_prev[1] = ay;
+        g_prev[2] = az;
+        out[0] = TimedSample{ax, ay, az};
+        return 1;
+    }
+
+    const std::int32_t jitter = static_cast<std::int32_t>(ts_us - grid_time_us(g_grid_n));
+    note_jitter(slot_jitter_us(ts_us, g_grid_n));
+
+    std::size_t produced = 0;
+    const float bound = TIMING_JITTER_BOUND_US;
+
+    if (static_cast<float>(jitter < 0 ? -jitter : jitter) <= bound) {
+        // Close enough: the sample takes its grid slot unchanged
+        out[produced++] = TimedSample{ax, ay, az};
+        ++g_grid_n;
+    } else {
+        // Interpolate every grid slot in (prev, ts]. An early sample may
+        // produce no slot at all; a late one (missed reads) fills the gap.
+        const float span = static_cast<float>(ts_us - g_prev_ts_us);
+
+        while (static_cast<std::int32_t>(ts_us - grid_time_us(g_grid_n)) >= 0) {
+            if (produced + 1 == max_out &&
+                static_cast<std::int32_t>(ts_us - grid_time_us(g_grid_n + 1)) >= 0) {
+                // Gap too long to bridge: count the slots still open as
+                // dropped and restart the grid on this sample, which takes
+                // the last output slot as-is
+                g_stats.dropped_samples += static_cast<std::uint32_t>(
+                    static_cast<float>(ts_us - grid_time_us(g_grid_n)) / SAMPLE_PERIOD_US + 0.5f);
+                out[produced++] = TimedSample{ax, ay, az};
+                g_grid_t0_us = ts_us;
+                g_grid_n     = 1;
+                break;
+            }
+
+            const float w = (span > 0.0f)
+                ? static_cast<float>(grid_time_us(g_grid_n) - g_prev_ts_us) / span
+                : 1.0f;
+            out[produced++] = TimedSample{
+                g_prev[0] + w * (ax - g_prev[0]),
+                g_prev[1] + w * (ay - g_prev[1]),
+                g_prev[2] + w * (az - g_prev[2])
+            };
+            ++g_grid_n;
+        }
+
+        g_stats.resampled_samples += static_cast<std::uint32_t>(produced);
+        if (produced > 1) {
+            g_stats.filled_samples += static_cast<std::uint32_t>(produced - 1);
+        }
+    }
+
+    g_prev_ts_us = ts_us;
+    g_prev[0] = ax;
+    g_prev[1] = ay;
+    g_prev[2] = az;
+
+    return produced;
+}
+
+std::size_t timing_check_fifo(std::uint32_t ts_us,
+                              std::size_t available_sets,
+                              std::size_t drained_last_poll)
+{
+    if (!g_fifo_primed) {
+        g_fifo_primed     = true;
+        g_fifo_prev_ts    = ts_us;
+        g_fifo_prev_avail = available_sets;
+        g_fifo_carry      = 0.0f;
+        return 0;
+    }
+
+    // Sets the sensor produced since the previous poll, by its own clock
+    const float set_period_us = 1000000.0f / ACQ_ODR_HZ;
+    const float produced_f = static_cast<float>(ts_us - g_fifo_prev_ts) / set_period_us + g_fifo_carry;
+    const std::size_t produced = static_cast<std::size_t>(produced_f);
+    g_fifo_carry = produced_f - static_cast<float>(produced);
+
+    // Signed: a poll may drain more than its own snapshot of the FIFO level
+    // (sets produced while it was reading), and those sets are part of
+    // produced. Only the final difference is clamped.
+    const long expected = static_cast<long>(g_fifo_prev_avail) + static_cast<long>(produced) -
+                          static_cast<long>(drained_last_poll);
+
+    g_fifo_prev_ts    = ts_us;
+    g_fifo_prev_avail = available_sets;
+
+    // Allow a couple of sets of slack for the timestamp / status read skew
+    std::size_t lost = 0;
+    if (expected > static_cast<long>(available_sets) + 2) {
+        lost = static_cast<std::size_t>(expected - static_cast<long>(available_sets));
+        g_stats.dropped_samples += static_cast<std::uint32_t>(
+            (lost + ACQ_OVERSAMPLE_FACTOR / 2) / ACQ_OVERSAMPLE_FACTOR);
+    }
+
+    return lost;
+}
+
+void timing_note_fifo_fill(std::size_t sets)
+{
+    g_stats.filled_samples += static_cast<std::uint32_t>(
+        (sets + ACQ_OVERSAMPLE_FACTOR / 2) / ACQ_OVERSAMPLE_FACTOR);
+}
+
+void timing_note_sample_cost(std::uint32_t ticks)
+{
+    if (ticks > g_stats.max_sample_ticks) {
+        g_stats.max_sample_ticks = ticks;
+    }
+}
+
+void timing_note_window_close(std::uint32_t ticks)
+{
+    g_stats.last_close_ticks = ticks;
+    if (ticks > g_stats.max_close_ticks) {
+        g_stats.max_close_ticks = ticks;
+    }
+}
+
+void timing_window_done(std::uint32_t close_us, std::uint32_t process_us)
+{
+    g_stats.last_process_us = process_us;
+    if (process_us > g_stats.max_process_us) {
+        g_stats.max_process_us = process_us;
+    }
+    if (static_cast<float>(process_us) > PROCESS_DEADLINE_US) {
+        ++g_stats.deadline_misses;
+    }
+
+    if (g_window_primed) {
+        const float interval_us = static_cast<float>(close_us - g_window_prev_us);
+        if (interval_us > WINDOW_SECONDS * 1000000.0f + LATE_WINDOW_TOLERANCE_US) {
+            ++g_stats.late_windows;
+        }
+    }
+    g_window_primed  = true;
+    g_window_prev_us = close_us;
+}
@@ -0,0 +1,118 @@
+#include "window_accumulator.h"
+#include "fft_utils.h"
+
+#include <cmath>
+
+// cos(2*pi*i/N); sin is read from the same table a quarter period earlier
+static float g_acc_cos[FFT_LENGTH];
+static bool  g_acc_table_ready = false;
+
+static_assert((FFT_LENGTH & (FFT_LENGTH - 1)) == 0, "FFT_LENGTH must be a power of two");
+static_assert(SAMPLES_PER_WINDOW <= FFT_LENGTH, "window must fit in FFT_LENGTH");
+
+static void init_acc_table()
+{
+    for (std::size_t i = 0; i < FFT_LENGTH; ++i) {
+        g_acc_cos[i] = static_cast<float>(std::cos(2.0 * M_PI * static_cast<double>(i) /
+                                                   static_cast<double>(FFT_LENGTH)));
+    }
+    g_acc_table_ready = true;
+}
+
+void window_acc_reset(WindowAccumulator &acc)
+{
+    if (!g_acc_table_ready) {
+        init_acc_table();
+    }
+
+    acc.n        = 0;
+    acc.mag_mean = 0.0f;
+    acc.mag_m2   = 0.0f;
+
+    acc.steps           = 0;
+    acc.step_seen       = false;
+    acc.last_step_index = 0;
+
+    for (std::size_t k = 0; k < ACC_SPECTRUM_BINS; ++k) {
+        acc.re[k] = 0.0f;
+        acc.im[k] = 0.0f;
+    }
+}
+
+void window_acc_push_mag(WindowAccumulator &acc, float mag)
+{
+    const std::size_t i = acc.n;
+    if (i >= FFT_LENGTH) {
+        return;
+    }
+
+    // Welford update
+    const float delta = mag - acc.mag_mean;
+    acc.mag_mean += delta / static_cast<float>(i + 1);
+    acc.mag_m2   += delta * (mag - acc.mag_mean);
+
+    // Threshold + minimum-interval step detector (see estimate_step_count)
+    if (mag > STEP_MAG_THRESHOLD_G) {
+        if (!acc.step_seen) {
+            ++acc.steps;
+            acc.step_seen       = true;
+            acc.last_step_index = i;
+        } else if (i >= acc.last_step_index + STEP_MIN_INTERVAL) {
+            ++acc.steps;
+            acc.last_step_index = i;
+        }
+    }
+
+    // X[k] += x[i] * e^{-j 2 pi k i / N}; the twiddle index advances by i per bin
+    constexpr std::size_t mask    = FFT_LENGTH - 1;
+    constexpr std::size_t quarter = FFT_LENGTH / 4;
+    std::size_t idx = 0;
+    for (std::size_t k = 0; k < ACC_SPECTRUM_BINS; ++k) {
+        acc.re[k] += mag * g_acc_cos[idx];
+        acc.im[k] -= mag * g_acc_cos[(idx - quarter) & mask];
+        idx = (idx + i) & mask;
+    }
+
+    acc.n = i + 1;
+}
+
+void window_acc_push(WindowAccumulator &acc, float ax, float ay, float az)
+{
+    window_acc_push_mag(acc, std::sqrt(ax * ax + ay * ay + az * az));
+}
+
+void window_acc_finish(const WindowAccumulator &acc,
+                       float *spectrum_out,
+                       std::uint16_t &step_count,
+                       float &mag_variance)
+{
+    step_count   = acc.steps;
+    mag_variance = (acc.n > 0) ? acc.mag_m2 / static_cast<float>(acc.n) : 0.0f;
+
+    const float scale = (acc.n > 0) ? 1.0f / static_cast<float>(acc.n) : 0.0f;
+    for (std::size_t k = 0; k < ACC_SPECTRUM_BINS; ++k) {
+        spectrum_out[k] = std::sqrt(acc.re[k] * acc.re[k] + acc.im[k] * acc.im[k]) * scale;
+    }
+}
+
+static WindowAccumulator g_wrapper_acc;
+
+void compute_streaming_dft_magnitude(const float *time_data,
+                                     std::size_t time_samples,
+                                     float *mag_out,
+                                     std::size_t fft_length)
+{
+    if (fft_length != FFT_LENGTH || time_samples == 0 || time_samples > FFT_LENGTH) {
+        compute_dft_magnitude(time_data, time_samples, mag_out, fft_length);
+        return;
+    }
+
+    window_acc_reset(g_wrapper_acc);
+    for (std::size_t i = 0; i < time_samples; ++i) {
+        window_acc_push_mag(g_wrapper_acc, time_data[i]);
+    }
+
+    std::uint16_t steps = 0;
+    float variance = 0.0f;
+    window_acc_finish(g_wrapper_acc, mag_out, steps, variance);
+}
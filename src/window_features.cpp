@@ -0,0 +1,100 @@
+#include "window_features.h"
+#include "config.h"
+#include "detector.h"
+
+#include <cmath>
+
+const char *const FEATURE_NAMES[NUM_FEATURES] = {
+    "tremor_rms",
+    "dysk_rms",
+    "gait_rms",
+    "dominant_hz",
+    "spectral_entropy",
+    "cadence_hz",
+    "mag_variance",
+};
+
+FeatureVector build_features(const float *spectrum_mag,
+                             std::size_t spectrum_bins,
+                             std::uint16_t step_count,
+                             float mag_variance)
+{
+    FeatureVector fv{};
+
+    // Band RMS exactly as the detector always computed it
+    integrate_bands(spectrum_mag, spectrum_bins,
+                    fv.v[FEAT_TREMOR_RMS_G],
+                    fv.v[FEAT_DYSK_RMS_G]);
+
+    // One pass over the non-DC bins: total power, gait band, dominant bin
+    const float df = SAMPLE_FREQUENCY_HZ / static_cast<float>(FFT_LENGTH);
+
+    float total_power = 0.0f;
+    float gait_power  = 0.0f;
+    std::size_t gait_bins = 0;
+    std::size_t peak_bin  = 0;
+    float peak_mag = 0.0f;
+
+    for (std::size_t k = 1; k < spectrum_bins; ++k) {
+        const float m = spectrum_mag[k];
+        const float p = m * m;
+        const float f = df * static_cast<float>(k);
+
+        total_power += p;
+        if (f >= GAIT_F_MIN_HZ && f < GAIT_F_MAX_HZ) {
+            gait_power += p;
+            ++gait_bins;
+        }
+        if (m > peak_mag) {
+            peak_mag = m;
+            peak_bin = k;
+        }
+    }
+
+    if (gait_bins > 0) {
+        fv.v[FEAT_GAIT_RMS_G] = std::sqrt(gait_power / static_cast<float>(gait_bins));
+    }
+    fv.v[FEAT_DOMINANT_HZ] = df * static_cast<float>(peak_bin);
+
+    // Entropy of the normalised power distribution, scaled to 0..1
+    if (total_power > 0.0f && spectrum_bins > 2) {
+        float h = 0.0f;
+        for (std::size_t k = 1; k < spectrum_bins; ++k) {
+            const float p = spectrum_mag[k] * spectrum_mag[k] / total_power;
+            if (p > 0.0f) {
+                h -= p * std::log(p);
+            }
+        }
+        fv.v[FEAT_SPECTRAL_ENTROPY] = h / std::log(static_cast<float>(spectrum_bins - 1));
+    }
+
+    fv.v[FEAT_CADENCE_HZ]      = static_cast<float>(step_count) / WINDOW_SECONDS;
+    fv.v[FEAT_MAG_VARIANCE_G2] = mag_variance;
+
+    return fv;
+}
+
+FeatureVector extract_features(const float *mag,
+                               std::size_t n,
+                               const float *spectrum_mag,
+                               std::size_t spectrum_bins,
+                               std::uint16_t step_count)
+{
+    // Two-pass variance of |a|
+    float var = 0.0f;
+    if (n > 0) {
+        float mean = 0.0f;
+        for (std::size_t i = 0; i < n; ++i) {
+            mean += mag[i];
+        }
+        mean /= static_cast<float>(n);
+
+        for (std::size_t i = 0; i < n; ++i) {
+            const float d = mag[i] - mean;
+            var += d * d;
+        }
+        var /= static_cast<float>(n);
+    }
+
+    return build_features(spectrum_mag, spectrum_bins, step_count, var);
+}
@@ -0,0 +1,189 @@
+#include "window_history.h"
+
+static_assert(HISTORY_WINDOWS >= 2, "HISTORY_WINDOWS must hold at least two windows");
+
+static const float &value_at(const WindowHistory &h, std::uint32_t seq, std::size_t f)
+{
+    return h.ring[seq % HISTORY_WINDOWS].v[f];
+}
+
+static std::uint32_t queue_front(const TrendQueue &q)
+{
+    return q.seq[q.head];
+}
+
+static std::uint32_t queue_back(const TrendQueue &q)
+{
+    return q.seq[(q.head + q.count - 1) % HISTORY_WINDOWS];
+}
+
+// Drop the window that is about to leave the ring (only ever at the front)
+static void queue_expire(TrendQueue &q, std::uint32_t oldest_kept)
+{
+    if (q.count > 0 && queue_front(q) < oldest_kept) {
+        q.head = (q.head + 1) % HISTORY_WINDOWS;
+        --q.count;
+    }
+}
+
+// Append seq after removing every entry it dominates; each window enters and
+// leaves a queue once, so this is O(1) amortised
+template <typename Dominates>
+static void queue_push(TrendQueue &q, const WindowHistory &h, std::size_t f,
+                       std::uint32_t seq, Dominates dominates)
+{
+    const float y = value_at(h, seq, f);
+    while (q.count > 0 && dominates(y, value_at(h, queue_back(q), f))) {
+        --q.count;
+    }
+    q.seq[(q.head + q.count) % HISTORY_WINDOWS] = seq;
+    ++q.count;
+}
+
+// Exact sums from the ring; run once per lap of the ring so float rounding
+// in the running updates cannot build up
+static void resync_sums(WindowHistory &h)
+{
+    const std::size_t n = history_count(h);
+    const std::uint32_t oldest = h.pushed - static_cast<std::uint32_t>(n);
+
+    for (std::size_t f = 0; f < NUM_FEATURES; ++f) {
+        float sy  = 0.0f;
+        float sxy = 0.0f;
+        for (std::size_t x = 0; x < n; ++x) {
+            const float y = value_at(h, oldest + static_cast<std::uint32_t>(x), f);
+            sy  += y;
+            sxy += static_cast<float>(x) * y;
+        }
+        h.sum_y[f]  = sy;
+        h.sum_xy[f] = sxy;
+    }
+}
+
+// Least-squares slope of n equally spaced values (x = 0 .. n-1)
+static float slope_from_sums(std::size_t n, float sum_y, float sum_xy)
+{
+    if (n < 2) {
+        return 0.0f;
+    }
+    const float fn    = static_cast<float>(n);
+    const float sx    = 0.5f * fn * (fn - 1.0f);
+    const float denom = fn * fn * (fn * fn - 1.0f) / 12.0f;   // n*Sxx - Sx^2
+    return (fn * sum_xy - sx * sum_y) / denom;
+}
+
+void history_reset(WindowHistory &h)
+{
+    h.pushed = 0;
+    for (std::size_t f = 0; f < NUM_FEATURES; ++f) {
+        h.ema[f]    = 0.0f;
+        h.sum_y[f]  = 0.0f;
+        h.sum_xy[f] = 0.0f;
+        h.min_q[f].head  = 0;
+        h.min_q[f].count = 0;
+        h.max_q[f].head  = 0;
+        h.max_q[f].count = 0;
+    }
+}
+
+void history_push(WindowHistory &h, const FeatureVector &features)
+{
+    const std::uint32_t seq  = h.pushed;
+    const std::size_t   n    = history_count(h);
+    const bool          full = (n == HISTORY_WINDOWS);
+    const std::uint32_t oldest_kept = full ? seq + 1 - HISTORY_WINDOWS : 0;
+
+    for (std::size_t f = 0; f < NUM_FEATURES; ++f) {
+        const float y = features.v[f];
+
+        h.ema[f] = (seq == 0) ? y : h.ema[f] + HISTORY_EMA_ALPHA * (y - h.ema[f]);
+
+        // Slope sums, x counted from the oldest window held
+        if (full) {
+            // The ring shifts by one: every x drops by 1 and the new value
+            // enters at x = HISTORY_WINDOWS - 1
+            const float y_old = value_at(h, seq, f);   // slot about to be overwritten
+            h.sum_y[f]  += y - y_old;
+            h.sum_xy[f] += static_cast<float>(HISTORY_WINDOWS) * y - h.sum_y[f];
+        } else {
+            h.sum_y[f]  += y;
+            h.sum_xy[f] += static_cast<float>(n) * y;
+        }
+
+        // Expire before the slot is overwritten, the queues still read it
+        queue_expire(h.min_q[f], oldest_kept);
+        queue_expire(h.max_q[f], oldest_kept);
+    }
+
+    h.ring[seq % HISTORY_WINDOWS] = features;
+    h.pushed = seq + 1;
+
+    for (std::size_t f = 0; f < NUM_FEATURES; ++f) {
+        queue_push(h.min_q[f], h, f, seq, [](float y, float back) { return y <= back; });
+        queue_push(h.max_q[f], h, f, seq, [](float y, float back) { return y >= back; });
+    }
+
+    if (h.pushed % HISTORY_WINDOWS == 0) {
+        resync_sums(h);
+    }
+}
+
+std::size_t history_count(const WindowHistory &h)
+{
+    return (h.pushed < HISTORY_WINDOWS) ? h.pushed : HISTORY_WINDOWS;
+}
+
+FeatureTrend history_trend(const WindowHistory &h, FeatureIndex feature)
+{
+    FeatureTrend t = {0.0f, 0.0f, 0.0f, 0.0f};
+    const std::size_t n = history_count(h);
+    if (n == 0) {
+        return t;
+    }
+
+    const std::size_t f = static_cast<std::size_t>(feature);
+    t.ema   = h.ema[f];
+    t.min   = value_at(h, queue_front(h.min_q[f]), f);
+    t.max   = value_at(h, queue_front(h.max_q[f]), f);
+    t.slope = slope_from_sums(n, h.sum_y[f], h.sum_xy[f]);
+    return t;
+}
+
+const FeatureVector &history_at(const WindowHistory &h, std::size_t age)
+{
+    return h.ring[(h.pushed - 1 - static_cast<std::uint32_t>(age)) % HISTORY_WINDOWS];
+}
+
+FeatureTrend history_trend_reference(const WindowHistory &h, FeatureIndex feature)
+{
+    FeatureTrend t = {0.0f, 0.0f, 0.0f, 0.0f};
+    const std::size_t n = history_count(h);
+    if (n == 0) {
+        return t;
+    }
+
+    const std::size_t f = static_cast<std::size_t>(feature);
+    const float mean_x = 0.5f * static_cast<float>(n - 1);
+    float mean_y = 0.0f;
+    t.min = history_at(h, 0).v[f];
+    t.max = t.min;
+    for (std::size_t age = 0; age < n; ++age) {
+        const float y = history_at(h, age).v[f];
+        mean_y += y;
+        t.min = (y < t.min) ? y : t.min;
+        t.max = (y > t.max) ? y : t.max;
+    }
+    mean_y /= static_cast<float>(n);
+
+    float sxy = 0.0f;
+    float sxx = 0.0f;
+    for (std::size_t age = 0; age < n; ++age) {
+        const float dx = static_cast<float>(n - 1 - age) - mean_x;
+        sxy += dx * (history_at(h, age).v[f] - mean_y);
+        sxx += dx * dx;
+    }
+
+    t.ema   = h.ema[f];
+    t.slope = (n < 2) ? 0.0f : sxy / sxx;
+    return t;
+}
@@ -0,0 +1,25 @@
+// Host entry point for the kernel benchmarks in src/bench.cpp.
+// Build with PlatformIO (`pio run -e bench_host && .pio/build/bench_host/program`)
+// or directly:
+//   g++ -std=c++14 -O2 -Iinclude tools/bench_host.cpp src/bench.cpp src/decimator.cpp
+//       src/fft_utils.cpp src/window_features.cpp src/classifier.cpp src/detector.cpp
+//       src/window_accumulator.cpp -o bench_host
+
+#include "bench.h"
+
+#include <cstdarg>
+#include <cstdio>
+
+static void host_printf(const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    std::vprintf(fmt, args);
+    va_end(args);
+}
+
+int main()
+{
+    run_benchmarks(host_printf);
+    return 0;
+}
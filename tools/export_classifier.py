@@ -0,0 +1,342 @@
+#!/usr/bin/env python3
+"""Train the on-device int8 decision-tree ensemble and export it as a C header.
+
+Input is a CSV with one row per window: the feature columns in the order of
+FeatureIndex (include/window_features.h), which is also what the firmware prints in
+its [FEAT] serial lines, plus the labels `tremor_level` and `dysk_level`
+(0..3):
+
+    tremor_rms,dysk_rms,gait_rms,dominant_hz,spectral_entropy,cadence_hz,mag_variance,tremor_level,dysk_level
+
+Without --csv the script synthesises feature vectors and labels them with the
+firmware's threshold ladder (config.h), which gives a model that reproduces
+the current behaviour until labelled recordings are available.
+
+Features are quantised to int8 with a per-feature affine mapping fitted to the
+training data; trees are trained directly on the quantised values, so the C
+inference (classifier.cpp) makes exactly the same decisions as this script.
+
+Standard library only:
+    python3 tools/export_classifier.py --csv windows.csv --out include/classifier_model.h
+    python3 tools/export_classifier.py --synthetic 4000 --out include/classifier_model.h
+"""
+
+import argparse
+import csv
+import math
+import os
+import random
+import re
+import struct
+import sys
+
+FEATURES = [
+    "tremor_rms",
+    "dysk_rms",
+    "gait_rms",
+    "dominant_hz",
+    "spectral_entropy",
+    "cadence_hz",
+    "mag_variance",
+]
+HEADS = ["tremor_level", "dysk_level"]
+NUM_CLASSES = 4
+
+HEAD_FEATURE = {"tremor_level": "tremor_rms", "dysk_level": "dysk_rms"}
+HEAD_CONFIG_PREFIX = {"tremor_level": "TREMOR", "dysk_level": "DYSK"}
+
+CONFIG_H = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "include", "config.h")
+
+# Read from config.h by load_config()
+LEVEL_THRESHOLDS = {}
+MAX_NODE_VISITS = 0
+
+
+# ------------------------------------------------------------
+# Firmware configuration
+# ------------------------------------------------------------
+
+def load_config(path):
+    """Take the level thresholds and the node visit budget from config.h."""
+    global MAX_NODE_VISITS
+    with open(path) as f:
+        text = f.read()
+    values = {}
+    for m in re.finditer(r"static\s+constexpr\s+[\w:]+\s+(\w+)\s*=\s*([0-9.eE+-]+)[fFuU]*\s*;", text):
+        values[m.group(1)] = float(m.group(2))
+
+    def get(name):
+        if name not in values:
+            sys.exit("%s: %s not found" % (path, name))
+        return values[name]
+
+    for head, prefix in HEAD_CONFIG_PREFIX.items():
+        LEVEL_THRESHOLDS[head] = tuple(get("%s_LEVEL%d_RMS_G" % (prefix, i)) for i in (1, 2, 3))
+    MAX_NODE_VISITS = int(get("CLASSIFIER_MAX_NODE_VISITS"))
+
+
+# ------------------------------------------------------------
+# Data
+# ------------------------------------------------------------
+
+def ladder(value, thresholds):
+    level = 0
+    for t in thresholds:
+        if value >= t:
+            level += 1
+    return level
+
+
+def load_csv(path):
+    rows = []
+    with open(path, newline="") as f:
+        for rec in csv.DictReader(f):
+            x = [float(rec[name]) for name in FEATURES]
+            y = [int(rec[head]) for head in HEADS]
+            rows.append((x, y))
+    if not rows:
+        sys.exit("no rows in %s" % path)
+    return rows
+
+
+def synthesise(count, rng):
+    """Plausible feature vectors, labelled by the threshold ladder."""
+    rows = []
+    for _ in range(count):
+        tremor = math.exp(rng.uniform(math.log(0.003), math.log(0.4)))
+        dysk = math.exp(rng.uniform(math.log(0.003), math.log(0.4)))
+        walking = rng.random() < 0.4
+        x = [
+            tremor,
+            dysk,
+            rng.uniform(0.05, 0.3) if walking else rng.uniform(0.0, 0.05),
+            rng.uniform(0.2, 25.0),
+            rng.uniform(0.2, 1.0),
+            rng.uniform(0.6, 2.5) if walking else rng.choice([0.0, 0.0, 0.333]),
+            rng.uniform(0.0, 0.1),
+        ]
+        y = [ladder(x[FEATURES.index(HEAD_FEATURE[h])], LEVEL_THRESHOLDS[h]) for h in HEADS]
+        rows.append((x, y))
+    return rows
+
+
+# ------------------------------------------------------------
+# Quantisation: q = clamp(floor(x * inv_scale + 0.5) + zero_point, -128, 127)
+# ------------------------------------------------------------
+
+def fit_quantisation(rows):
+    params = []
+    for i in range(len(FEATURES)):
+        lo = min(r[0][i] for r in rows)
+        hi = max(r[0][i] for r in rows)
+        lo = min(lo, 0.0)
+        if hi <= lo:
+            hi = lo + 1.0
+        inv_scale = 255.0 / (hi - lo)
+        zero_point = int(-128 - math.floor(lo * inv_scale + 0.5))
+        zero_point = max(-128, min(127, zero_point))
+        params.append((inv_scale, zero_point))
+    return params
+
+
+def quantise(x, params):
+    q = []
+    for v, (inv_scale, zp) in zip(x, params):
+        # float32 inv_scale as stored in the header
+        qi = math.floor(v * to_f32(inv_scale) + 0.5) + zp
+        q.append(max(-128, min(127, qi)))
+    return q
+
+
+def to_f32(v):
+    return struct.unpack("f", struct.pack("f", v))[0]
+
+
+# ------------------------------------------------------------
+# CART (Gini) on int8 features
+# ------------------------------------------------------------
+
+def gini(counts, total):
+    if total == 0:
+        return 0.0
+    return 1.0 - sum((c / total) ** 2 for c in counts)
+
+
+def build_tree(q, samples, labels, depth, max_depth, min_leaf, nodes, leaves):
+    counts = [0] * NUM_CLASSES
+    for i in samples:
+        counts[labels[i]] += 1
+    total = len(samples)
+
+    def make_leaf():
+        # Class distribution scaled to int8 (0..127)
+        scores = [int(round(127.0 * c / total)) for c in counts]
+        leaves.append(scores)
+        nodes.append([-1, 0, len(leaves) - 1, 0])
+        return len(nodes) - 1
+
+    if depth == max_depth or total < 2 * min_leaf or max(counts) == total:
+        return make_leaf()
+
+    best = None
+    parent = gini(counts, total)
+    for f in range(len(FEATURES)):
+        order = sorted(samples, key=lambda i: q[i][f])
+        left = [0] * NUM_CLASSES
+        right = counts[:]
+        for pos in range(total - 1):
+            i = order[pos]
+            left[labels[i]] += 1
+            right[labels[i]] -= 1
+            a, b = q[i][f], q[order[pos + 1]][f]
+            n_left = pos + 1
+            if a == b or n_left < min_leaf or total - n_left < min_leaf:
+                continue
+            score = (n_left * gini(left, n_left) + (total - n_left) * gini(right, total - n_left)) / total
+            if best is None or score < best[0]:
+                best = (score, f, a)
+
+    if best is None or best[0] >= parent - 1e-12:
+        return make_leaf()
+
+    _, f, thr = best
+    index = len(nodes)
+    nodes.append([f, thr, 0, 0])
+    left_s = [i for i in samples if q[i][f] <= thr]
+    right_s = [i for i in samples if q[i][f] > thr]
+    nodes[index][2] = build_tree(q, left_s, labels, depth + 1, max_depth, min_leaf, nodes, leaves)
+    nodes[index][3] = build_tree(q, right_s, labels, depth + 1, max_depth, min_leaf, nodes, leaves)
+    return index
+
+
+def predict(q, roots, nodes, leaves):
+    scores = [0] * NUM_CLASSES
+    for root in roots:
+        n = root
+        while nodes[n][0] >= 0:
+            n = nodes[n][2] if q[nodes[n][0]] <= nodes[n][1] else nodes[n][3]
+        for c in range(NUM_CLASSES):
+            scores[c] += leaves[nodes[n][2]][c]
+    # Ties go to the lower level (same as the C argmax)
+    return max(range(NUM_CLASSES), key=lambda c: (scores[c], -c))
+
+
+# ------------------------------------------------------------
+# Export
+# ------------------------------------------------------------
+
+def write_header(path, params, roots, nodes, leaves, args, accuracy, source):
+    trees = args.trees
+    lines = []
+    w = lines.append
+    w("#ifndef CLASSIFIER_MODEL_H")
+    w("#define CLASSIFIER_MODEL_H")
+    w("")
+    w("// Generated by tools/export_classifier.py -- do not edit by hand.")
+    w("// Source: %s" % source)
+    w("// %d heads x %d trees, max depth %d, %d nodes, %d leaves" %
+      (len(HEADS), trees, args.depth, len(nodes), len(leaves)))
+    w("// Training accuracy: %s" % ", ".join("%s %.2f%%" % (h, 100.0 * a) for h, a in zip(HEADS, accuracy)))
+    w("")
+    w("#include <cstddef>")
+    w("#include <cstdint>")
+    w("")
+    w('#include "classifier.h"')
+    w("")
+    w("static constexpr std::size_t CLF_NUM_HEADS      = %d;" % len(HEADS))
+    w("static constexpr std::size_t CLF_TREES_PER_HEAD = %d;" % trees)
+    w("static constexpr std::size_t CLF_MAX_DEPTH      = %d;" % args.depth)
+    w("static constexpr std::size_t CLF_NUM_NODES      = %d;" % len(nodes))
+    w("static constexpr std::size_t CLF_NUM_LEAVES     = %d;" % len(leaves))
+    w("")
+    w("// q = clamp(floor(x * inv_scale + 0.5) + zero_point, -128, 127), FeatureIndex order")
+    w("static const float CLF_FEATURE_INV_SCALE[NUM_FEATURES] = {")
+    for (inv_scale, _), name in zip(params, FEATURES):
+        w("    %.9ef,  // %s" % (to_f32(inv_scale), name))
+    w("};")
+    w("")
+    w("static const std::int8_t CLF_FEATURE_ZERO_POINT[NUM_FEATURES] = {")
+    w("    " + ", ".join(str(zp) for _, zp in params))
+    w("};")
+    w("")
+    w("// { feature, threshold, left, right }: go left when q[feature] <= threshold.")
+    w("// Leaves have feature = -1 and left = index into CLF_LEAF_SCORES.")
+    w("static const ClassifierNode CLF_NODES[CLF_NUM_NODES] = {")
+    for f, thr, left, right in nodes:
+        w("    { %d, %d, %d, %d }," % (f, thr, left, right))
+    w("};")
+    w("")
+    w("// Per-leaf class scores (levels 0..3), summed over the trees of a head")
+    w("static const std::int8_t CLF_LEAF_SCORES[CLF_NUM_LEAVES][4] = {")
+    for s in leaves:
+        w("    { %s }," % ", ".join(str(v) for v in s))
+    w("};")
+    w("")
+    w("// Root node of every tree, per head (tremor, dyskinesia)")
+    w("static const std::uint16_t CLF_TREE_ROOT[CLF_NUM_HEADS][CLF_TREES_PER_HEAD] = {")
+    for head_roots in roots:
+        w("    { %s }," % ", ".join(str(r) for r in head_roots))
+    w("};")
+    w("")
+    w("#endif // CLASSIFIER_MODEL_H")
+
+    with open(path, "w") as f:
+        f.write("\n".join(lines) + "\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    src = parser.add_mutually_exclusive_group(required=True)
+    src.add_argument("--csv", help="training data (feature columns + tremor_level, dysk_level)")
+    src.add_argument("--synthetic", type=int, metavar="N", help="synthesise N ladder-labelled windows")
+    parser.add_argument("--out", default="include/classifier_model.h")
+    parser.add_argument("--config", default=CONFIG_H, help="firmware config.h (thresholds, node budget)")
+    parser.add_argument("--trees", type=int, default=4, help="trees per head")
+    parser.add_argument("--depth", type=int, default=4, help="maximum tree depth")
+    parser.add_argument("--min-leaf", type=int, default=4, help="minimum samples per leaf")
+    parser.add_argument("--seed", type=int, default=1)
+    args = parser.parse_args()
+    load_config(args.config)
+
+    visits = len(HEADS) * args.trees * args.depth
+    if visits > MAX_NODE_VISITS:
+        sys.exit("%d heads x %d trees x depth %d = %d node visits > budget %d" %
+                 (len(HEADS), args.trees, args.depth, visits, MAX_NODE_VISITS))
+
+    rng = random.Random(args.seed)
+    if args.csv:
+        rows = load_csv(args.csv)
+        source = "%s (%d windows)" % (args.csv, len(rows))
+    else:
+        rows = synthesise(args.synthetic, rng)
+        source = "synthetic, %d windows labelled by the config.h threshold ladder (seed %d)" % (
+            args.synthetic, args.seed)
+
+    params = fit_quantisation(rows)
+    q = [quantise(x, params) for x, _ in rows]
+
+    nodes, leaves, roots, accuracy = [], [], [], []
+    for h in range(len(HEADS)):
+        labels = [y[h] for _, y in rows]
+        head_roots = []
+        for t in range(args.trees):
+            # The first tree sees all data, the others bootstrap samples
+            if t == 0:
+                sample = list(range(len(rows)))
+            else:
+                sample = [rng.randrange(len(rows)) for _ in rows]
+            head_roots.append(build_tree(q, sample, labels, 0, args.depth, args.min_leaf, nodes, leaves))
+        roots.append(head_roots)
+        correct = sum(1 for i in range(len(rows)) if predict(q[i], head_roots, nodes, leaves) == labels[i])
+        accuracy.append(correct / len(rows))
+
+    if len(nodes) > 65535:
+        sys.exit("model too large: %d nodes" % len(nodes))
+
+    write_header(args.out, params, roots, nodes, leaves, args, accuracy, source)
+    print("wrote %s: %d nodes, %d leaves, accuracy %s" % (
+        args.out, len(nodes), len(leaves), ", ".join("%s %.2f%%" % (h, 100 * a) for h, a in zip(HEADS, accuracy))))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,735 @@
+// Multi-wearer gateway: accepts many device streams over TCP (stand-in for
+// the BLE link, see gateway_protocol.h), runs one WearerPipeline per wearer
+// on a shared worker pool and publishes the per-window results.
+//
+// Threads:
+//   - main thread: poll() loop that accepts connections, reassembles frames
+//     into each stream's bounded frame queue and prints [GW] statistics;
+//   - workers: take ready streams from a shared run queue, run a few frames
+//     through the stream's pipeline and publish the results.
+//
+// A stream is scheduled as a unit (at most once in the run queue, at most
+// one worker at a time), so its pipeline needs no locking and samples stay
+// in order. Backpressure: a stream whose frame queue is full is not polled
+// for input any more, so TCP flow control slows that sender down instead of
+// the gateway buffering without bound.
+//
+// Usage: gateway [--port P] [--workers N] [--report S] [--publish PATH|-]
+//   --publish writes one [GW] line per window (to stdout for "-").
+//
+// Build with PlatformIO: pio run -e gateway && .pio/build/gateway/program
+// (the README has the equivalent g++ command line).
+
+#include "gateway_protocol.h"
+#include "latency_stats.h"
+#include "wearer_pipeline.h"
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+// Frames buffered per stream before it is throttled (32 x 13 sets ≈ 8 s @ 52 Hz)
+static constexpr std::size_t GW_STREAM_QUEUE_FRAMES = 32;
+
+// Bytes of not yet parsed input kept per stream
+static constexpr std::size_t GW_RX_BUFFER_BYTES = 2048;
+
+// Frames a worker runs for one stream before giving the others a turn
+static constexpr std::size_t GW_WORKER_BATCH_FRAMES = 4;
+
+// Latency samples kept for the final report (later windows only enter the
+// interval reports)
+static constexpr std::size_t GW_MAX_TOTAL_LATENCY_SAMPLES = 1u << 20;
+
+static_assert(GW_RX_BUFFER_BYTES >= GW_MAX_FRAME_BYTES, "rx buffer must hold a full frame");
+
+struct SampleFrame {
+    std::size_t   sets;
+    std::int16_t  xyz[GW_MAX_SETS_PER_FRAME * 3];
+    std::uint64_t rx_ns;  // when the gateway had the complete frame
+};
+
+struct Stream {
+    int fd = -1;
+
+    // I/O thread only
+    std::uint32_t wearer_id  = 0;
+    bool          hello_done = false;
+    bool          throttled  = false;  // queue was full at the last parse
+    std::uint32_t stalls     = 0;      // times the queue filled up
+    std::uint8_t  rx[GW_RX_BUFFER_BYTES];
+    std::size_t   rx_len = 0;
+
+    std::atomic<bool> eof{false};        // no more input will be parsed
+    std::atomic<bool> write_failed{false};
+
+    // Guards the frame queue and the scheduled flag
+    std::mutex  mu;
+    SampleFrame queue[GW_STREAM_QUEUE_FRAMES];
+    std::size_t q_head    = 0;
+    std::size_t q_count   = 0;
+    bool        scheduled = false;  // in the run queue or on a worker
+
+    // Worker holding the stream only
+    WearerPipeline pipe;
+    std::uint64_t  samples = 0;
+    std::uint32_t  dropped_results = 0;
+};
+
+typedef std::shared_ptr<Stream> StreamPtr;
+
+struct WorkerStats {
+    std::atomic<std::uint64_t> busy_ns{0};  // thread CPU time spent on streams
+    std::atomic<std::uint64_t> samples{0};
+    std::atomic<std::uint64_t> windows{0};
+    std::atomic<std::uint64_t> dropped_results{0};
+
+    std::mutex                 lat_mu;
+    std::vector<std::uint32_t> latency_us;  // since the last report
+};
+
+static std::mutex              g_run_mu;
+static std::condition_variable g_run_cv;
+static std::deque<StreamPtr>   g_run_queue;
+static bool                    g_stop = false;  // guarded by g_run_mu
+
+static int g_wake_rd = -1;  // self-pipe: workers wake the poll() loop
+static int g_wake_wr = -1;
+
+static std::FILE *g_publish = nullptr;
+static std::mutex g_publish_mu;
+
+static volatile sig_atomic_t g_signalled = 0;
+
+static std::uint64_t now_ns()
+{
+    using namespace std::chrono;
+    return static_cast<std::uint64_t>(
+        duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+}
+
+// CPU time of the calling thread; unlike wall time it does not count
+// time the worker was preempted
+static std::uint64_t thread_cpu_ns()
+{
+    timespec ts{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<std::uint64_t>(ts.tv_sec) * 1000000000u + static_cast<std::uint64_t>(ts.tv_nsec);
+}
+
+static double cpu_seconds()
+{
+    rusage ru{};
+    getrusage(RUSAGE_SELF, &ru);
+    return static_cast<double>(ru.ru_utime.tv_sec + ru.ru_stime.tv_sec) +
+           1e-6 * static_cast<double>(ru.ru_utime.tv_usec + ru.ru_stime.tv_usec);
+}
+
+static void on_signal(int)
+{
+    g_signalled = 1;
+}
+
+static void wake_io_thread()
+{
+    const std::uint8_t b = 1;
+    // A full pipe already guarantees a wake-up
+    (void)!write(g_wake_wr, &b, 1);
+}
+
+static bool set_nonblocking(int fd)
+{
+    const int flags = fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+// Caller holds s.mu
+static void schedule_locked(const StreamPtr &s)
+{
+    if (s->scheduled) {
+        return;
+    }
+    s->scheduled = true;
+    {
+        std::lock_guard<std::mutex> lk(g_run_mu);
+        g_run_queue.push_back(s);
+    }
+    g_run_cv.notify_one();
+}
+
+// ------------------------------------------------------------
+// Workers
+// ------------------------------------------------------------
+
+static void publish(Stream &s, const DetectionResult &res, std::uint64_t rx_ns, WorkerStats &ws)
+{
+    const std::uint32_t seq = s.pipe.windows - 1;
+
+    // Result frame back to the device, like the BLE notifications
+    if (!s.write_failed) {
+        std::uint8_t frame[GW_RESULT_BYTES];
+        frame[0] = GW_FRAME_RESULT;
+        frame[1] = res.tremor_level;
+        frame[2] = res.dyskinesia_level;
+        frame[3] = res.fog_level;
+        gw_put_u32(frame + 4, seq);
+
+        const ssize_t n = send(s.fd, frame, sizeof(frame), MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            // Device is not reading its results: drop rather than block the pool
+            ++s.dropped_results;
+            ws.dropped_results.fetch_add(1, std::memory_order_relaxed);
+        } else if (n != static_cast<ssize_t>(sizeof(frame))) {
+            // Error or partial frame: the result stream is unusable, end the connection
+            s.write_failed = true;
+            shutdown(s.fd, SHUT_RDWR);
+        }
+    }
+
+    const std::uint64_t latency_ns = now_ns() - rx_ns;
+    {
+        std::lock_guard<std::mutex> lk(ws.lat_mu);
+        ws.latency_us.push_back(static_cast<std::uint32_t>(latency_ns / 1000u));
+    }
+    ws.windows.fetch_add(1, std::memory_order_relaxed);
+
+    if (g_publish) {
+        std::lock_guard<std::mutex> lk(g_publish_mu);
+        std::fprintf(g_publish,
+                     "[GW] wearer=%lu win=%lu tremor_lvl=%u dysk_lvl=%u fog=%u "
+                     "tremor_rms=%.4f dysk_rms=%.4f step_hz=%.2f\n",
+                     static_cast<unsigned long>(s.wearer_id),
+                     static_cast<unsigned long>(seq),
+                     res.tremor_level,
+                     res.dyskinesia_level,
+                     res.fog_level,
+                     res.tremor_band_rms_g,
+                     res.dyskinesia_band_rms_g,
+                     res.step_rate_hz);
+    }
+}
+
+static void worker_main(WorkerStats *ws)
+{
+    SampleFrame batch[GW_WORKER_BATCH_FRAMES];
+
+    for (;;) {
+        StreamPtr s;
+        {
+            std::unique_lock<std::mutex> lk(g_run_mu);
+            g_run_cv.wait(lk, [] { return g_stop || !g_run_queue.empty(); });
+            if (g_stop) {
+                return;
+            }
+            s = g_run_queue.front();
+            g_run_queue.pop_front();
+        }
+
+        const std::uint64_t t0 = thread_cpu_ns();
+
+        std::size_t n = 0;
+        bool was_full = false;
+        {
+            std::lock_guard<std::mutex> lk(s->mu);
+            was_full = (s->q_count == GW_STREAM_QUEUE_FRAMES);
+            while (n < GW_WORKER_BATCH_FRAMES && s->q_count > 0) {
+                batch[n++] = s->queue[s->q_head];
+                s->q_head = (s->q_head + 1) % GW_STREAM_QUEUE_FRAMES;
+                --s->q_count;
+            }
+        }
+
+        std::uint64_t samples = 0;
+        for (std::size_t f = 0; f < n; ++f) {
+            const SampleFrame &frame = batch[f];
+            for (std::size_t i = 0; i < frame.sets; ++i) {
+                DetectionResult res;
+                if (wearer_pipeline_push(s->pipe, &frame.xyz[3 * i], res)) {
+                    publish(*s, res, frame.rx_ns, *ws);
+                }
+            }
+            samples += frame.sets;
+        }
+        s->samples += samples;
+
+        ws->samples.fetch_add(samples, std::memory_order_relaxed);
+        ws->busy_ns.fetch_add(thread_cpu_ns() - t0, std::memory_order_relaxed);
+
+        bool finished = false;
+        {
+            std::lock_guard<std::mutex> lk(s->mu);
+            if (s->q_count > 0) {
+                // Back of the queue, so one busy stream cannot starve the others
+                std::lock_guard<std::mutex> rlk(g_run_mu);
+                g_run_queue.push_back(s);
+            } else {
+                s->scheduled = false;
+                finished = s->eof;
+            }
+        }
+        g_run_cv.notify_one();
+
+        // Space was freed in a throttled queue, or a closed stream is idle now
+        if (was_full || finished) {
+            wake_io_thread();
+        }
+    }
+}
+
+// ------------------------------------------------------------
+// I/O thread
+// ------------------------------------------------------------
+
+static void end_stream(Stream &s, const char *why)
+{
+    if (!s.eof) {
+        if (why) {
+            std::fprintf(stderr, "[GW] wearer=%lu fd=%d: %s\n",
+                         static_cast<unsigned long>(s.wearer_id), s.fd, why);
+        }
+        s.eof = true;
+        shutdown(s.fd, SHUT_RD);
+    }
+}
+
+// Move complete frames from the rx buffer into the frame queue
+static void parse_frames(const StreamPtr &sp)
+{
+    Stream &s = *sp;
+    std::size_t off = 0;
+
+    while (s.rx_len - off >= GW_HEADER_BYTES) {
+        const std::uint8_t *p = s.rx + off;
+        const std::size_t size = gw_frame_size(p);
+        if (size == 0 || p[0] == GW_FRAME_RESULT) {
+            end_stream(s, "protocol error");
+            break;
+        }
+        if (s.rx_len - off < size) {
+            break;
+        }
+
+        if (p[0] == GW_FRAME_HELLO) {
+            if (s.hello_done || p[1] != GW_PROTO_VERSION) {
+                end_stream(s, "bad HELLO");
+                break;
+            }
+            s.wearer_id  = gw_get_u32(p + 4);
+            s.hello_done = true;
+            off += size;
+            continue;
+        }
+
+        if (!s.hello_done) {
+            end_stream(s, "samples before HELLO");
+            break;
+        }
+
+        std::lock_guard<std::mutex> lk(s.mu);
+        if (s.q_count == GW_STREAM_QUEUE_FRAMES) {
+            if (!s.throttled) {
+                s.throttled = true;
+                ++s.stalls;
+            }
+            break;
+        }
+        s.throttled = false;
+
+        SampleFrame &f = s.queue[(s.q_head + s.q_count) % GW_STREAM_QUEUE_FRAMES];
+        f.sets  = p[1];
+        f.rx_ns = now_ns();
+        for (std::size_t i = 0; i < 3 * f.sets; ++i) {
+            f.xyz[i] = static_cast<std::int16_t>(gw_get_u16(p + GW_HEADER_BYTES + 2 * i));
+        }
+        ++s.q_count;
+        schedule_locked(sp);
+
+        off += size;
+    }
+
+    if (off > 0) {
+        std::memmove(s.rx, s.rx + off, s.rx_len - off);
+        s.rx_len -= off;
+    }
+}
+
+static void read_stream(const StreamPtr &s)
+{
+    const ssize_t n = recv(s->fd, s->rx + s->rx_len, GW_RX_BUFFER_BYTES - s->rx_len, 0);
+    if (n > 0) {
+        s->rx_len += static_cast<std::size_t>(n);
+        parse_frames(s);
+    } else if (n == 0) {
+        end_stream(*s, nullptr);
+    } else if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+        end_stream(*s, std::strerror(errno));
+    }
+}
+
+// Whether the stream can take more input right now
+static bool wants_input(Stream &s)
+{
+    if (s.eof || s.rx_len == GW_RX_BUFFER_BYTES) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lk(s.mu);
+    return s.q_count < GW_STREAM_QUEUE_FRAMES;
+}
+
+static int open_listener(std::uint16_t port)
+{
+    const int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return -1;
+    }
+
+    const int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    sockaddr_in addr{};
+    addr.sin_family      = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port        = htons(port);
+
+    if (bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0 ||
+        listen(fd, SOMAXCONN) != 0 ||
+        !set_nonblocking(fd)) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static void accept_streams(int listen_fd, std::vector<StreamPtr> &streams)
+{
+    for (;;) {
+        const int fd = accept(listen_fd, nullptr, nullptr);
+        if (fd < 0) {
+            return;
+        }
+
+        const int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        if (!set_nonblocking(fd)) {
+            close(fd);
+            continue;
+        }
+
+        StreamPtr s = std::make_shared<Stream>();
+        s->fd = fd;
+        wearer_pipeline_reset(s->pipe);
+        streams.push_back(s);
+    }
+}
+
+// Close streams that hit EOF once their queued frames have been processed;
+// their stall counts move to closed_stalls
+static void reap_streams(std::vector<StreamPtr> &streams, std::uint32_t &closed_stalls)
+{
+    for (std::size_t i = 0; i < streams.size();) {
+        Stream &s = *streams[i];
+        bool idle = false;
+        if (s.eof) {
+            std::lock_guard<std::mutex> lk(s.mu);
+            idle = !s.scheduled && s.q_count == 0;
+        }
+        if (!idle) {
+            ++i;
+            continue;
+        }
+
+        if (s.hello_done) {
+            std::fprintf(stderr, "[GW] wearer=%lu closed: samples=%llu, windows=%lu, stalls=%lu, dropped=%lu\n",
+                         static_cast<unsigned long>(s.wearer_id),
+                         static_cast<unsigned long long>(s.samples),
+                         static_cast<unsigned long>(s.pipe.windows),
+                         static_cast<unsigned long>(s.stalls),
+                         static_cast<unsigned long>(s.dropped_results));
+        }
+        closed_stalls += s.stalls;
+        close(s.fd);
+        streams[i] = streams.back();
+        streams.pop_back();
+    }
+}
+
+// ------------------------------------------------------------
+// Reporting
+// ------------------------------------------------------------
+
+struct ReportTotals {
+    std::uint64_t t_ns;
+    double        cpu_s;
+    std::uint64_t busy_ns;
+    std::uint64_t samples;
+    std::uint64_t windows;
+    std::uint64_t dropped;
+};
+
+static ReportTotals collect_totals(std::vector<std::unique_ptr<WorkerStats>> &workers,
+                                   std::vector<std::uint32_t> &latency_us)
+{
+    ReportTotals t{};
+    t.t_ns  = now_ns();
+    t.cpu_s = cpu_seconds();
+    for (auto &w : workers) {
+        t.busy_ns += w->busy_ns.load(std::memory_order_relaxed);
+        t.samples += w->samples.load(std::memory_order_relaxed);
+        t.windows += w->windows.load(std::memory_order_relaxed);
+        t.dropped += w->dropped_results.load(std::memory_order_relaxed);
+
+        std::lock_guard<std::mutex> lk(w->lat_mu);
+        latency_us.insert(latency_us.end(), w->latency_us.begin(), w->latency_us.end());
+        w->latency_us.clear();
+    }
+    return t;
+}
+
+// One [GW] line for the interval prev -> cur.
+// rt_streams: real-time 52 Hz streams the gateway kept up with;
+// streams/core: rt_streams per core actually busy (workers only / whole process)
+static void print_report(const char *tag,
+                         const ReportTotals &prev,
+                         const ReportTotals &cur,
+                         std::size_t connected,
+                         std::uint32_t stalls,
+                         std::vector<std::uint32_t> &latency_us)
+{
+    const double dt = 1e-9 * static_cast<double>(cur.t_ns - prev.t_ns);
+    if (dt <= 0.0) {
+        return;
+    }
+
+    const double rt_streams = static_cast<double>(cur.samples - prev.samples) /
+                              (static_cast<double>(SAMPLE_FREQUENCY_HZ) * dt);
+    const double busy_cores = 1e-9 * static_cast<double>(cur.busy_ns - prev.busy_ns) / dt;
+    const double cpu_cores  = (cur.cpu_s - prev.cpu_s) / dt;
+    const LatencySummary lat = summarize_latency(latency_us);
+
+    std::printf("[GW] %s %.1f s: streams=%lu, rt_streams=%.1f, windows=%llu, "
+                "lat_us p50=%lu p95=%lu p99=%lu max=%lu, busy_cores=%.3f, cpu_cores=%.3f, "
+                "streams/core=%.0f (workers) %.0f (process), stalls=%lu, dropped=%llu\n",
+                tag,
+                dt,
+                static_cast<unsigned long>(connected),
+                rt_streams,
+                static_cast<unsigned long long>(cur.windows - prev.windows),
+                static_cast<unsigned long>(lat.p50_us),
+                static_cast<unsigned long>(lat.p95_us),
+                static_cast<unsigned long>(lat.p99_us),
+                static_cast<unsigned long>(lat.max_us),
+                busy_cores,
+                cpu_cores,
+                busy_cores > 0.0 ? rt_streams / busy_cores : 0.0,
+                cpu_cores > 0.0 ? rt_streams / cpu_cores : 0.0,
+                static_cast<unsigned long>(stalls),
+                static_cast<unsigned long long>(cur.dropped - prev.dropped));
+    std::fflush(stdout);
+}
+
+// ------------------------------------------------------------
+// main
+// ------------------------------------------------------------
+
+static void usage()
+{
+    std::fprintf(stderr, "usage: gateway [--port P] [--workers N] [--report S] [--publish PATH|-]\n");
+}
+
+int main(int argc, char **argv)
+{
+    std::uint16_t port = GW_DEFAULT_PORT;
+    unsigned hw = std::thread::hardware_concurrency();
+    std::size_t num_workers = (hw > 1) ? hw - 1 : 1;
+    double report_s = 5.0;
+    const char *publish_path = nullptr;
+
+    for (int i = 1; i < argc; ++i) {
+        const bool has_value = (i + 1 < argc);
+        if (!std::strcmp(argv[i], "--port") && has_value) {
+            port = static_cast<std::uint16_t>(std::atoi(argv[++i]));
+        } else if (!std::strcmp(argv[i], "--workers") && has_value) {
+            num_workers = static_cast<std::size_t>(std::atoi(argv[++i]));
+        } else if (!std::strcmp(argv[i], "--report") && has_value) {
+            report_s = std::atof(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--publish") && has_value) {
+            publish_path = argv[++i];
+        } else {
+            usage();
+            return 2;
+        }
+    }
+    if (num_workers == 0 || report_s <= 0.0) {
+        usage();
+        return 2;
+    }
+
+    if (publish_path) {
+        g_publish = std::strcmp(publish_path, "-") ? std::fopen(publish_path, "a") : stdout;
+        if (!g_publish) {
+            std::perror(publish_path);
+            return 1;
+        }
+    }
+
+    signal(SIGPIPE, SIG_IGN);
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+
+    int wake[2];
+    if (pipe(wake) != 0 || !set_nonblocking(wake[0]) || !set_nonblocking(wake[1])) {
+        std::perror("pipe");
+        return 1;
+    }
+    g_wake_rd = wake[0];
+    g_wake_wr = wake[1];
+
+    const int listen_fd = open_listener(port);
+    if (listen_fd < 0) {
+        std::perror("listen");
+        return 1;
+    }
+
+    wearer_pipeline_init();
+
+    std::vector<std::unique_ptr<WorkerStats>> stats;
+    std::vector<std::thread> workers;
+    for (std::size_t i = 0; i < num_workers; ++i) {
+        stats.emplace_back(new WorkerStats);
+    }
+    for (std::size_t i = 0; i < num_workers; ++i) {
+        workers.emplace_back(worker_main, stats[i].get());
+    }
+
+    std::printf("[GW] listening on port %u, %lu workers, window %lu samples @ %.0f Hz\n",
+                port,
+                static_cast<unsigned long>(num_workers),
+                static_cast<unsigned long>(SAMPLES_PER_WINDOW),
+                static_cast<double>(SAMPLE_FREQUENCY_HZ));
+    std::fflush(stdout);
+
+    std::vector<StreamPtr> streams;
+    std::vector<pollfd> pfds;
+    std::vector<StreamPtr> polled;
+    std::vector<std::uint32_t> latency_us;
+
+    const std::uint64_t report_ns = static_cast<std::uint64_t>(report_s * 1e9);
+    const ReportTotals start = collect_totals(stats, latency_us);
+    std::vector<std::uint32_t> all_latency_us;
+    ReportTotals last = start;
+    std::uint32_t closed_stalls = 0;
+
+    const auto total_stalls = [&streams, &closed_stalls]() {
+        std::uint32_t n = closed_stalls;
+        for (const StreamPtr &s : streams) {
+            n += s->stalls;
+        }
+        return n;
+    };
+    const auto keep_for_total = [&all_latency_us](const std::vector<std::uint32_t> &v) {
+        const std::size_t room = GW_MAX_TOTAL_LATENCY_SAMPLES - all_latency_us.size();
+        all_latency_us.insert(all_latency_us.end(), v.begin(), v.begin() + std::min(room, v.size()));
+    };
+
+    while (!g_signalled) {
+        pfds.clear();
+        polled.clear();
+        pfds.push_back({listen_fd, POLLIN, 0});
+        pfds.push_back({g_wake_rd, POLLIN, 0});
+        for (const StreamPtr &s : streams) {
+            if (wants_input(*s)) {
+                pfds.push_back({s->fd, POLLIN, 0});
+                polled.push_back(s);
+            }
+        }
+
+        const std::uint64_t now = now_ns();
+        const std::uint64_t due = last.t_ns + report_ns;
+        const int timeout_ms = (due > now) ? static_cast<int>((due - now) / 1000000u) + 1 : 0;
+
+        const int ready = poll(pfds.data(), pfds.size(), timeout_ms);
+        if (ready < 0 && errno != EINTR) {
+            std::perror("poll");
+            break;
+        }
+
+        if (ready > 0) {
+            if (pfds[1].revents & POLLIN) {
+                std::uint8_t buf[256];
+                while (read(g_wake_rd, buf, sizeof(buf)) > 0) {
+                }
+            }
+            if (pfds[0].revents & POLLIN) {
+                accept_streams(listen_fd, streams);
+            }
+            for (std::size_t i = 0; i < polled.size(); ++i) {
+                if (pfds[i + 2].revents & (POLLIN | POLLHUP | POLLERR)) {
+                    read_stream(polled[i]);
+                }
+            }
+        }
+
+        // Frames left in rx buffers by a full queue
+        for (const StreamPtr &s : streams) {
+            if (s->throttled && !s->eof) {
+                parse_frames(s);
+            }
+        }
+        reap_streams(streams, closed_stalls);
+
+        if (now_ns() >= last.t_ns + report_ns) {
+            const ReportTotals cur = collect_totals(stats, latency_us);
+            keep_for_total(latency_us);
+            print_report("interval", last, cur, streams.size(), total_stalls(), latency_us);
+            latency_us.clear();
+            last = cur;
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lk(g_run_mu);
+        g_stop = true;
+    }
+    g_run_cv.notify_all();
+    for (std::thread &t : workers) {
+        t.join();
+    }
+
+    const ReportTotals end = collect_totals(stats, latency_us);
+    keep_for_total(latency_us);
+    print_report("total", start, end, streams.size(), total_stalls(), all_latency_us);
+
+    for (const StreamPtr &s : streams) {
+        close(s->fd);
+    }
+    close(listen_fd);
+    if (g_publish && g_publish != stdout) {
+        std::fclose(g_publish);
+    }
+    return 0;
+}
@@ -0,0 +1,86 @@
+#ifndef GATEWAY_PROTOCOL_H
+#define GATEWAY_PROTOCOL_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Wire format between a wearer device (or the load generator) and the
+// gateway, carried over TCP as a stand-in for the BLE link. All fields are
+// little-endian; every frame starts with a 4-byte header whose first byte
+// is the frame type.
+//
+// Device -> gateway
+//   HELLO   (8 bytes)  : u8 type=1, u8 version, u16 reserved, u32 wearer_id
+//   SAMPLES (4 + 6n)   : u8 type=2, u8 n (1..GW_MAX_SETS_PER_FRAME), u16 reserved,
+//                        n x { i16 x, i16 y, i16 z } raw LSM6DSL counts (±2 g,
+//                        ACC_G_PER_LSB), already at SAMPLE_FREQUENCY_HZ
+// Gateway -> device
+//   RESULT  (8 bytes)  : u8 type=3, u8 tremor_level, u8 dyskinesia_level,
+//                        u8 fog_level, u32 window_seq (0 = first window)
+//
+// HELLO must be the first frame of a connection. RESULT carries the same
+// three levels as the BLE characteristics 0xF251..0xF253.
+
+static constexpr std::uint16_t GW_DEFAULT_PORT   = 7450;
+static constexpr std::uint8_t  GW_PROTO_VERSION  = 1;
+
+static constexpr std::uint8_t  GW_FRAME_HELLO    = 1;
+static constexpr std::uint8_t  GW_FRAME_SAMPLES  = 2;
+static constexpr std::uint8_t  GW_FRAME_RESULT   = 3;
+
+static constexpr std::size_t   GW_HEADER_BYTES   = 4;
+static constexpr std::size_t   GW_HELLO_BYTES    = 8;
+static constexpr std::size_t   GW_RESULT_BYTES   = 8;
+static constexpr std::size_t   GW_SET_BYTES      = 6;
+
+// 32 sets @ 52 Hz ≈ 0.6 s of data per frame at most
+static constexpr std::size_t   GW_MAX_SETS_PER_FRAME = 32;
+static constexpr std::size_t   GW_MAX_FRAME_BYTES =
+    GW_HEADER_BYTES + GW_MAX_SETS_PER_FRAME * GW_SET_BYTES;
+
+inline void gw_put_u16(std::uint8_t *p, std::uint16_t v)
+{
+    p[0] = static_cast<std::uint8_t>(v);
+    p[1] = static_cast<std::uint8_t>(v >> 8);
+}
+
+inline void gw_put_u32(std::uint8_t *p, std::uint32_t v)
+{
+    p[0] = static_cast<std::uint8_t>(v);
+    p[1] = static_cast<std::uint8_t>(v >> 8);
+    p[2] = static_cast<std::uint8_t>(v >> 16);
+    p[3] = static_cast<std::uint8_t>(v >> 24);
+}
+
+inline std::uint16_t gw_get_u16(const std::uint8_t *p)
+{
+    return static_cast<std::uint16_t>(p[0] | (p[1] << 8));
+}
+
+inline std::uint32_t gw_get_u32(const std::uint8_t *p)
+{
+    return static_cast<std::uint32_t>(p[0]) |
+           (static_cast<std::uint32_t>(p[1]) << 8) |
+           (static_cast<std::uint32_t>(p[2]) << 16) |
+           (static_cast<std::uint32_t>(p[3]) << 24);
+}
+
+// Size of the frame starting with header hdr, or 0 if the header is invalid
+inline std::size_t gw_frame_size(const std::uint8_t *hdr)
+{
+    switch (hdr[0]) {
+    case GW_FRAME_HELLO:
+        return GW_HELLO_BYTES;
+    case GW_FRAME_RESULT:
+        return GW_RESULT_BYTES;
+    case GW_FRAME_SAMPLES:
+        if (hdr[1] == 0 || hdr[1] > GW_MAX_SETS_PER_FRAME) {
+            return 0;
+        }
+        return GW_HEADER_BYTES + hdr[1] * GW_SET_BYTES;
+    default:
+        return 0;
+    }
+}
+
+#endif // GATEWAY_PROTOCOL_H
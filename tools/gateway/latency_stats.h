@@ -0,0 +1,40 @@
+#ifndef LATENCY_STATS_H
+#define LATENCY_STATS_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Percentiles of a set of latency samples (µs), shared by the gateway and
+// the load generator reports
+struct LatencySummary {
+    std::size_t   count;
+    std::uint32_t p50_us;
+    std::uint32_t p95_us;
+    std::uint32_t p99_us;
+    std::uint32_t max_us;
+};
+
+// Sorts samples in place
+inline LatencySummary summarize_latency(std::vector<std::uint32_t> &samples)
+{
+    LatencySummary s{};
+    s.count = samples.size();
+    if (samples.empty()) {
+        return s;
+    }
+
+    std::sort(samples.begin(), samples.end());
+    const auto at = [&samples](double q) {
+        const std::size_t i = static_cast<std::size_t>(q * static_cast<double>(samples.size() - 1) + 0.5);
+        return samples[i];
+    };
+    s.p50_us = at(0.50);
+    s.p95_us = at(0.95);
+    s.p99_us = at(0.99);
+    s.max_us = samples.back();
+    return s;
+}
+
+#endif // LATENCY_STATS_H
@@ -0,0 +1,539 @@
+// Load generator for the gateway: opens one connection per simulated wearer
+// and replays accelerometer recordings on them at (a multiple of) real time.
+// Reports the rate it sustained, whether every window came back, and the
+// end-to-end latency from sending a window's last sample to receiving its
+// RESULT frame.
+//
+// Usage: gateway_loadgen [--host A] [--port P] [--streams N] [--threads T]
+//                        [--seconds S] [--speed X] [--frame-sets K] [recording.csv ...]
+//   --speed X   each stream sends X times faster than 52 Hz (counts as X
+//               real-time streams)
+//   --frame-sets K  samples per SAMPLES frame (default 13 = 250 ms of data)
+//
+// Recording format: one sample per line, "ax,ay,az" in g at
+// SAMPLE_FREQUENCY_HZ; lines starting with '#' are skipped. Without
+// recordings, synthetic ones are used (rest, tremor, dyskinesia, walking
+// followed by a stop). Stream i replays recording i % count, starting at a
+// different offset.
+//
+// Build with PlatformIO: pio run -e gateway_loadgen && .pio/build/gateway_loadgen/program
+
+#include "config.h"
+#include "gateway_protocol.h"
+#include "latency_stats.h"
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+// Send times remembered per stream, indexed by window_seq % ring size
+static constexpr std::size_t LG_WINDOW_RING = 64;
+
+// How long to wait for outstanding results after the last frame
+static constexpr double LG_DRAIN_SECONDS = 2.0;
+
+struct Recording {
+    std::vector<std::int16_t> xyz;  // interleaved raw counts
+
+    std::size_t samples() const { return xyz.size() / 3; }
+};
+
+struct LoadStream {
+    int              fd = -1;
+    std::uint32_t    wearer_id = 0;
+    const Recording *rec = nullptr;
+    std::size_t      pos = 0;           // next sample in rec
+
+    std::uint64_t    sent = 0;          // samples fully handed to the socket
+    std::uint64_t    next_due_ns = 0;   // schedule for the next frame
+
+    std::uint8_t     tx[GW_MAX_FRAME_BYTES];
+    std::size_t      tx_len = 0;
+    std::size_t      tx_off = 0;
+    std::size_t      tx_sets = 0;
+    bool             tx_stalled = false;
+
+    std::uint8_t     rx[GW_RESULT_BYTES];
+    std::size_t      rx_len = 0;
+
+    std::uint64_t    window_sent_ns[LG_WINDOW_RING];
+    std::uint64_t    results = 0;
+    bool             failed = false;
+};
+
+struct ThreadResult {
+    std::uint64_t              samples = 0;
+    std::uint64_t              expected_windows = 0;
+    std::uint64_t              results = 0;
+    std::uint64_t              send_stalls = 0;  // frames that hit a full socket
+    std::uint64_t              final_lag_ns = 0; // worst distance behind schedule at the end
+    std::size_t                failed = 0;
+    std::vector<std::uint32_t> latency_us;
+};
+
+struct LoadConfig {
+    const char   *host = "127.0.0.1";
+    std::uint16_t port = GW_DEFAULT_PORT;
+    std::size_t   streams = 100;
+    std::size_t   threads = 1;
+    double        seconds = 30.0;
+    double        speed = 1.0;
+    std::size_t   frame_sets = 13;
+};
+
+static std::uint64_t now_ns()
+{
+    using namespace std::chrono;
+    return static_cast<std::uint64_t>(
+        duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+}
+
+// ------------------------------------------------------------
+// Recordings
+// ------------------------------------------------------------
+
+static std::int16_t g_to_raw(float g)
+{
+    const float raw = std::round(g / ACC_G_PER_LSB);
+    return static_cast<std::int16_t>(std::max(-32768.0f, std::min(32767.0f, raw)));
+}
+
+static bool load_recording(const char *path, Recording &rec)
+{
+    std::FILE *f = std::fopen(path, "r");
+    if (!f) {
+        return false;
+    }
+
+    char line[256];
+    while (std::fgets(line, sizeof(line), f)) {
+        if (line[0] == '#') {
+            continue;
+        }
+        float ax = 0.0f;
+        float ay = 0.0f;
+        float az = 0.0f;
+        if (std::sscanf(line, "%f,%f,%f", &ax, &ay, &az) == 3) {
+            rec.xyz.push_back(g_to_raw(ax));
+            rec.xyz.push_back(g_to_raw(ay));
+            rec.xyz.push_back(g_to_raw(az));
+        }
+    }
+    std::fclose(f);
+    return rec.samples() >= SAMPLES_PER_WINDOW;
+}
+
+// 60 s of rest, 4.5 Hz tremor, 6 Hz dyskinesia, and 40 s walking + 20 s stop
+static std::vector<Recording> synthetic_recordings()
+{
+    const std::size_t n = static_cast<std::size_t>(60.0f * SAMPLE_FREQUENCY_HZ);
+    const float two_pi = 2.0f * static_cast<float>(M_PI);
+    std::uint32_t seed = 0x2468ace1u;
+    const auto noise = [&seed]() {
+        seed = seed * 1664525u + 1013904223u;
+        return 0.004f * (static_cast<float>(seed >> 8) / 16777216.0f - 0.5f);
+    };
+
+    std::vector<Recording> recs(4);
+    for (std::size_t i = 0; i < n; ++i) {
+        const float t = static_cast<float>(i) / SAMPLE_FREQUENCY_HZ;
+        const float tremor = 0.10f * std::sin(two_pi * 4.5f * t);
+        const float dysk   = 0.10f * std::sin(two_pi * 6.0f * t);
+        const float step   = (t < 40.0f) ? 0.35f * std::pow(std::max(0.0f, std::sin(two_pi * 0.9f * t)), 4.0f) : 0.0f;
+
+        const float rows[4][3] = {
+            { noise(),          noise(), 1.0f + noise() },
+            { tremor + noise(), noise(), 1.0f + tremor + noise() },
+            { dysk + noise(),   noise(), 1.0f + dysk + noise() },
+            { noise(),          noise(), 1.0f + step + noise() },
+        };
+        for (std::size_t r = 0; r < 4; ++r) {
+            for (std::size_t a = 0; a < 3; ++a) {
+                recs[r].xyz.push_back(g_to_raw(rows[r][a]));
+            }
+        }
+    }
+    return recs;
+}
+
+// ------------------------------------------------------------
+// Streams
+// ------------------------------------------------------------
+
+static int connect_to(const LoadConfig &cfg)
+{
+    addrinfo hints{};
+    hints.ai_family   = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+
+    char port[8];
+    std::snprintf(port, sizeof(port), "%u", cfg.port);
+
+    addrinfo *res = nullptr;
+    if (getaddrinfo(cfg.host, port, &hints, &res) != 0 || !res) {
+        return -1;
+    }
+
+    const int fd = socket(res->ai_family, res->ai_socktype, res->ai_protocol);
+    if (fd >= 0 && connect(fd, res->ai_addr, res->ai_addrlen) != 0) {
+        close(fd);
+        freeaddrinfo(res);
+        return -1;
+    }
+    freeaddrinfo(res);
+
+    const int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    return fd;
+}
+
+static bool open_stream(const LoadConfig &cfg, LoadStream &s)
+{
+    s.fd = connect_to(cfg);
+    if (s.fd < 0) {
+        return false;
+    }
+
+    std::uint8_t hello[GW_HELLO_BYTES];
+    hello[0] = GW_FRAME_HELLO;
+    hello[1] = GW_PROTO_VERSION;
+    gw_put_u16(hello + 2, 0);
+    gw_put_u32(hello + 4, s.wearer_id);
+    if (send(s.fd, hello, sizeof(hello), MSG_NOSIGNAL) != static_cast<ssize_t>(sizeof(hello))) {
+        return false;
+    }
+
+    const int flags = fcntl(s.fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(s.fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+static void build_frame(LoadStream &s, std::size_t sets)
+{
+    s.tx[0] = GW_FRAME_SAMPLES;
+    s.tx[1] = static_cast<std::uint8_t>(sets);
+    gw_put_u16(s.tx + 2, 0);
+
+    std::uint8_t *p = s.tx + GW_HEADER_BYTES;
+    for (std::size_t i = 0; i < sets; ++i) {
+        const std::int16_t *xyz = &s.rec->xyz[3 * s.pos];
+        for (std::size_t a = 0; a < 3; ++a) {
+            gw_put_u16(p, static_cast<std::uint16_t>(xyz[a]));
+            p += 2;
+        }
+        s.pos = (s.pos + 1) % s.rec->samples();
+    }
+
+    s.tx_len  = GW_HEADER_BYTES + sets * GW_SET_BYTES;
+    s.tx_off  = 0;
+    s.tx_sets = sets;
+    s.tx_stalled = false;
+}
+
+// Returns false on a connection error
+static bool flush_frame(LoadStream &s, ThreadResult &tr)
+{
+    if (s.tx_len == 0) {
+        return true;
+    }
+
+    // Taken before each send(): the gateway may answer before send() returns
+    std::uint64_t t = 0;
+    while (s.tx_off < s.tx_len) {
+        const std::uint64_t t_send = now_ns();
+        const ssize_t n = send(s.fd, s.tx + s.tx_off, s.tx_len - s.tx_off, MSG_NOSIGNAL);
+        if (n > 0) {
+            s.tx_off += static_cast<std::size_t>(n);
+            t = t_send;
+        } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            // Gateway is pushing back
+            if (!s.tx_stalled) {
+                s.tx_stalled = true;
+                ++tr.send_stalls;
+            }
+            return true;
+        } else {
+            return false;
+        }
+    }
+
+    // Frame complete: remember when the send() that completed it started
+    const std::uint64_t first = s.sent;
+    s.sent += s.tx_sets;
+    for (std::uint64_t w = first / SAMPLES_PER_WINDOW; (w + 1) * SAMPLES_PER_WINDOW <= s.sent; ++w) {
+        if ((w + 1) * SAMPLES_PER_WINDOW > first) {
+            s.window_sent_ns[w % LG_WINDOW_RING] = t;
+        }
+    }
+    s.tx_len = 0;
+    return true;
+}
+
+// Returns false on a connection error or an unexpected frame
+static bool read_results(LoadStream &s, ThreadResult &tr)
+{
+    for (;;) {
+        const ssize_t n = recv(s.fd, s.rx + s.rx_len, GW_RESULT_BYTES - s.rx_len, 0);
+        if (n == 0) {
+            return false;
+        }
+        if (n < 0) {
+            return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+        }
+
+        s.rx_len += static_cast<std::size_t>(n);
+        if (s.rx_len < GW_RESULT_BYTES) {
+            continue;
+        }
+        s.rx_len = 0;
+        if (s.rx[0] != GW_FRAME_RESULT) {
+            return false;
+        }
+
+        const std::uint32_t seq = gw_get_u32(s.rx + 4);
+        if ((static_cast<std::uint64_t>(seq) + 1) * SAMPLES_PER_WINDOW <= s.sent) {
+            const std::uint64_t dt = now_ns() - s.window_sent_ns[seq % LG_WINDOW_RING];
+            tr.latency_us.push_back(static_cast<std::uint32_t>(dt / 1000u));
+        }
+        ++s.results;
+    }
+}
+
+static void run_streams(const LoadConfig *cfg, std::vector<LoadStream> *streams, ThreadResult *tr)
+{
+    const std::uint64_t period_ns = static_cast<std::uint64_t>(
+        1e9 * static_cast<double>(cfg->frame_sets) / (static_cast<double>(SAMPLE_FREQUENCY_HZ) * cfg->speed));
+    const std::uint64_t t0 = now_ns();
+    const std::uint64_t t_end = t0 + static_cast<std::uint64_t>(cfg->seconds * 1e9);
+    const std::uint64_t t_drain = t_end + static_cast<std::uint64_t>(LG_DRAIN_SECONDS * 1e9);
+
+    // Spread the streams over one frame period so frames do not arrive in lockstep
+    for (std::size_t i = 0; i < streams->size(); ++i) {
+        (*streams)[i].next_due_ns = t0 + period_ns * i / streams->size();
+    }
+
+    std::vector<pollfd> pfds(streams->size());
+
+    for (;;) {
+        const std::uint64_t now = now_ns();
+        const bool sending = now < t_end;
+        if (!sending) {
+            bool pending = false;
+            for (const LoadStream &s : *streams) {
+                pending |= !s.failed && s.results < s.sent / SAMPLES_PER_WINDOW;
+            }
+            if (!pending || now >= t_drain) {
+                break;
+            }
+        }
+
+        std::uint64_t next_due = sending ? t_end : t_drain;
+        for (LoadStream &s : *streams) {
+            if (s.failed) {
+                continue;
+            }
+            if (sending && s.tx_len == 0 && now >= s.next_due_ns) {
+                build_frame(s, cfg->frame_sets);
+                s.next_due_ns += period_ns;
+                if (!flush_frame(s, *tr)) {
+                    s.failed = true;
+                    continue;
+                }
+            }
+            if (s.tx_len == 0) {
+                // Streams with a frame pending wait for POLLOUT instead
+                next_due = std::min(next_due, s.next_due_ns);
+            }
+        }
+
+        for (std::size_t i = 0; i < streams->size(); ++i) {
+            const LoadStream &s = (*streams)[i];
+            pfds[i].fd      = s.failed ? -1 : s.fd;
+            pfds[i].events  = static_cast<short>(POLLIN | (s.tx_len ? POLLOUT : 0));
+            pfds[i].revents = 0;
+        }
+
+        const std::uint64_t t = now_ns();
+        const int timeout_ms = (next_due > t) ? static_cast<int>((next_due - t) / 1000000u) : 0;
+        if (poll(pfds.data(), pfds.size(), timeout_ms) < 0 && errno != EINTR) {
+            std::perror("poll");
+            break;
+        }
+
+        for (std::size_t i = 0; i < streams->size(); ++i) {
+            LoadStream &s = (*streams)[i];
+            if (s.failed) {
+                continue;
+            }
+            if ((pfds[i].revents & POLLOUT) && !flush_frame(s, *tr)) {
+                s.failed = true;
+            }
+            if ((pfds[i].revents & (POLLIN | POLLHUP | POLLERR)) && !read_results(s, *tr)) {
+                s.failed = true;
+            }
+        }
+    }
+
+    for (LoadStream &s : *streams) {
+        // A stream with a frame still pending is behind by at least that frame
+        const std::uint64_t due = s.next_due_ns - (s.tx_len ? period_ns : 0);
+        const std::uint64_t end = std::min(t_end, now_ns());
+        if (!s.failed && end > due) {
+            tr->final_lag_ns = std::max(tr->final_lag_ns, end - due);
+        }
+        tr->samples          += s.sent;
+        tr->expected_windows += s.sent / SAMPLES_PER_WINDOW;
+        tr->results          += s.results;
+        tr->failed           += s.failed ? 1 : 0;
+        close(s.fd);
+    }
+}
+
+// ------------------------------------------------------------
+// main
+// ------------------------------------------------------------
+
+static void usage()
+{
+    std::fprintf(stderr,
+                 "usage: gateway_loadgen [--host A] [--port P] [--streams N] [--threads T]\n"
+                 "                       [--seconds S] [--speed X] [--frame-sets K] [recording.csv ...]\n");
+}
+
+int main(int argc, char **argv)
+{
+    LoadConfig cfg;
+    std::vector<Recording> recs;
+
+    for (int i = 1; i < argc; ++i) {
+        const bool has_value = (i + 1 < argc);
+        if (!std::strcmp(argv[i], "--host") && has_value) {
+            cfg.host = argv[++i];
+        } else if (!std::strcmp(argv[i], "--port") && has_value) {
+            cfg.port = static_cast<std::uint16_t>(std::atoi(argv[++i]));
+        } else if (!std::strcmp(argv[i], "--streams") && has_value) {
+            cfg.streams = static_cast<std::size_t>(std::atol(argv[++i]));
+        } else if (!std::strcmp(argv[i], "--threads") && has_value) {
+            cfg.threads = static_cast<std::size_t>(std::atol(argv[++i]));
+        } else if (!std::strcmp(argv[i], "--seconds") && has_value) {
+            cfg.seconds = std::atof(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--speed") && has_value) {
+            cfg.speed = std::atof(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--frame-sets") && has_value) {
+            cfg.frame_sets = static_cast<std::size_t>(std::atol(argv[++i]));
+        } else if (argv[i][0] == '-') {
+            usage();
+            return 2;
+        } else {
+            Recording rec;
+            if (!load_recording(argv[i], rec)) {
+                std::fprintf(stderr, "%s: unreadable or shorter than one window\n", argv[i]);
+                return 1;
+            }
+            recs.push_back(rec);
+        }
+    }
+    if (cfg.streams == 0 || cfg.threads == 0 || cfg.seconds <= 0.0 || cfg.speed <= 0.0 ||
+        cfg.frame_sets == 0 || cfg.frame_sets > GW_MAX_SETS_PER_FRAME) {
+        usage();
+        return 2;
+    }
+    cfg.threads = std::min(cfg.threads, cfg.streams);
+    if (recs.empty()) {
+        recs = synthetic_recordings();
+    }
+
+    signal(SIGPIPE, SIG_IGN);
+
+    std::vector<std::vector<LoadStream>> groups(cfg.threads);
+    for (std::size_t i = 0; i < cfg.streams; ++i) {
+        groups[i % cfg.threads].emplace_back();
+        LoadStream &s = groups[i % cfg.threads].back();
+        s.wearer_id = static_cast<std::uint32_t>(i + 1);
+        s.rec       = &recs[i % recs.size()];
+        s.pos       = (i * 7919u) % s.rec->samples();
+    }
+    for (auto &g : groups) {
+        for (LoadStream &s : g) {
+            if (!open_stream(cfg, s)) {
+                std::fprintf(stderr, "[LOAD] wearer %lu: cannot connect to %s:%u: %s\n",
+                             static_cast<unsigned long>(s.wearer_id), cfg.host, cfg.port,
+                             std::strerror(errno));
+                return 1;
+            }
+        }
+    }
+
+    std::printf("[LOAD] %lu streams x %.2f real time, %lu threads, %.1f s, %lu sets/frame, %lu recordings\n",
+                static_cast<unsigned long>(cfg.streams), cfg.speed,
+                static_cast<unsigned long>(cfg.threads), cfg.seconds,
+                static_cast<unsigned long>(cfg.frame_sets),
+                static_cast<unsigned long>(recs.size()));
+    std::fflush(stdout);
+
+    std::vector<ThreadResult> results(cfg.threads);
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < cfg.threads; ++t) {
+        threads.emplace_back(run_streams, &cfg, &groups[t], &results[t]);
+    }
+    for (std::thread &t : threads) {
+        t.join();
+    }
+
+    ThreadResult total;
+    for (const ThreadResult &r : results) {
+        total.samples          += r.samples;
+        total.expected_windows += r.expected_windows;
+        total.results          += r.results;
+        total.send_stalls      += r.send_stalls;
+        total.failed           += r.failed;
+        total.final_lag_ns      = std::max(total.final_lag_ns, r.final_lag_ns);
+        total.latency_us.insert(total.latency_us.end(), r.latency_us.begin(), r.latency_us.end());
+    }
+
+    // Sustained: every stream is within two frames of its schedule at the end,
+    // no connection failed and every window came back
+    const double frame_s = static_cast<double>(cfg.frame_sets) /
+                           (static_cast<double>(SAMPLE_FREQUENCY_HZ) * cfg.speed);
+    const double lag_s = 1e-9 * static_cast<double>(total.final_lag_ns);
+    const bool sustained = lag_s <= 2.0 * frame_s && total.failed == 0 &&
+                           total.results >= total.expected_windows;
+
+    const LatencySummary lat = summarize_latency(total.latency_us);
+    std::printf("[LOAD] sent %llu samples (rt_streams=%.1f), windows %llu/%llu returned, failed=%lu\n",
+                static_cast<unsigned long long>(total.samples),
+                static_cast<double>(total.samples) / (static_cast<double>(SAMPLE_FREQUENCY_HZ) * cfg.seconds),
+                static_cast<unsigned long long>(total.results),
+                static_cast<unsigned long long>(total.expected_windows),
+                static_cast<unsigned long>(total.failed));
+    std::printf("[LOAD] end-to-end latency_us p50=%lu p95=%lu p99=%lu max=%lu (%lu windows)\n",
+                static_cast<unsigned long>(lat.p50_us),
+                static_cast<unsigned long>(lat.p95_us),
+                static_cast<unsigned long>(lat.p99_us),
+                static_cast<unsigned long>(lat.max_us),
+                static_cast<unsigned long>(lat.count));
+    std::printf("[LOAD] final lag %.1f ms (frame %.1f ms), send stalls %llu -> %s\n",
+                1e3 * lag_s, 1e3 * frame_s,
+                static_cast<unsigned long long>(total.send_stalls),
+                sustained ? "SUSTAINED" : "NOT SUSTAINED");
+    return sustained ? 0 : 1;
+}
@@ -0,0 +1,47 @@
+#include "wearer_pipeline.h"
+#include "config.h"
+#include "window_features.h"
+
+void wearer_pipeline_init()
+{
+    // Both tables are built lazily on first use; do it here, single-threaded
+    WindowAccumulator acc;
+    window_acc_reset(acc);
+
+    float spectrum[ACC_SPECTRUM_BINS] = {0.0f};
+    float tremor = 0.0f;
+    float dysk   = 0.0f;
+    integrate_bands(spectrum, ACC_SPECTRUM_BINS, tremor, dysk);
+}
+
+void wearer_pipeline_reset(WearerPipeline &p)
+{
+    window_acc_reset(p.acc);
+    fog_state_reset(p.fog);
+    p.windows = 0;
+}
+
+bool wearer_pipeline_push(WearerPipeline &p, const std::int16_t xyz[3], DetectionResult &res)
+{
+    window_acc_push(p.acc,
+                    xyz[0] * ACC_G_PER_LSB,
+                    xyz[1] * ACC_G_PER_LSB,
+                    xyz[2] * ACC_G_PER_LSB);
+
+    if (p.acc.n < SAMPLES_PER_WINDOW) {
+        return false;
+    }
+
+    float spectrum[ACC_SPECTRUM_BINS];
+    std::uint16_t step_count = 0;
+    float mag_variance = 0.0f;
+    window_acc_finish(p.acc, spectrum, step_count, mag_variance);
+
+    const FeatureVector features = build_features(spectrum, ACC_SPECTRUM_BINS,
+                                                  step_count, mag_variance);
+    res = detect_conditions(features, p.fog);
+
+    window_acc_reset(p.acc);
+    ++p.windows;
+    return true;
+}
@@ -0,0 +1,30 @@
+#ifndef WEARER_PIPELINE_H
+#define WEARER_PIPELINE_H
+
+#include <cstdint>
+
+#include "detector.h"
+#include "window_accumulator.h"
+
+// One wearer's instance of the firmware detection pipeline:
+// streaming accumulator -> features -> classifier stage + FOG.
+// Instances are independent; one instance must only be used by one
+// thread at a time.
+struct WearerPipeline {
+    WindowAccumulator acc;
+    FogState          fog;
+    std::uint32_t     windows;  // windows completed so far
+};
+
+// Build the shared lookup tables (accumulator twiddles, band ranges).
+// Call once from the main thread before pipelines run on worker threads.
+void wearer_pipeline_init();
+
+void wearer_pipeline_reset(WearerPipeline &p);
+
+// Add one sample (raw LSM6DSL counts at SAMPLE_FREQUENCY_HZ).
+// Returns true when it completed a window; res then holds the result of
+// window number p.windows - 1.
+bool wearer_pipeline_push(WearerPipeline &p, const std::int16_t xyz[3], DetectionResult &res);
+
+#endif // WEARER_PIPELINE_H
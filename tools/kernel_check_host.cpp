@@ -0,0 +1,25 @@
+// Host entry point for the kernel differential check in src/kernel_check.cpp.
+// Exit code is non-zero when a variant exceeds its error budget.
+// Build with PlatformIO (`pio run -e kernel_check_host && .pio/build/kernel_check_host/program`)
+// or directly (one line):
+//   g++ -std=c++14 -O2 -Iinclude tools/kernel_check_host.cpp src/kernel_check.cpp
+//       src/fft_utils.cpp src/detector.cpp src/classifier.cpp src/window_accumulator.cpp
+//       src/window_history.cpp src/publish_filter.cpp -o kernel_check_host
+
+#include "kernel_check.h"
+
+#include <cstdarg>
+#include <cstdio>
+
+static void host_printf(const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    std::vprintf(fmt, args);
+    va_end(args);
+}
+
+int main()
+{
+    return run_kernel_check(host_printf) ? 0 : 1;
+}
@@ -0,0 +1,197 @@
+// Host check for the sample timing layer (src/sample_timing.cpp): the legacy
+// grid resampler fed with synthetic sensor timestamps (missed reads, early /
+// late jitter, a gap longer than the output burst) and the FIFO overrun
+// accounting for a stalled poll loop.
+//
+// Prints one [TIM] line per check; exit code 1 if a check fails. Build with
+// PlatformIO (pio run -e sample_timing_host) or directly:
+//   g++ -std=c++14 -O2 -Iinclude tools/sample_timing_host.cpp src/sample_timing.cpp -o sample_timing_host
+
+#include "config.h"
+#include "sample_timing.h"
+
+#include <cmath>
+#include <cstdio>
+
+static int g_failures = 0;
+
+static void check(bool cond, const char *name)
+{
+    std::printf("[TIM] %-54s %s\n", name, cond ? "PASS" : "FAIL");
+    if (!cond) {
+        ++g_failures;
+    }
+}
+
+// ------------------------------------------------------------
+// Legacy mode: grid resampler
+// ------------------------------------------------------------
+
+static constexpr std::uint32_t GRID_T0_US = 1000000;
+static constexpr std::size_t   BURST      = 4;  // as in main.cpp acquire_direct()
+
+// Sensor time of grid slot n (same rounding as the resampler)
+static std::uint32_t slot_us(std::uint32_t n)
+{
+    return GRID_T0_US + static_cast<std::uint32_t>(
+        static_cast<std::uint64_t>(n) * 1000000ULL * 1000ULL /
+        static_cast<std::uint64_t>(SAMPLE_FREQUENCY_HZ * 1000.0f));
+}
+
+// Samples emitted so far; ax carries the sample's own value so interpolated
+// slots can be told apart
+static TimedSample g_out[64];
+static std::size_t g_emitted = 0;
+
+static std::size_t push(std::uint32_t ts_us, float value)
+{
+    TimedSample burst[BURST];
+    const std::size_t n = timing_push_sample(ts_us, value, 0.0f, 1.0f, burst, BURST);
+    for (std::size_t i = 0; i < n && g_emitted < 64; ++i) {
+        g_out[g_emitted++] = burst[i];
+    }
+    return n;
+}
+
+static void start_grid()
+{
+    timing_reset();
+    g_emitted = 0;
+    push(slot_us(0), 0.0f);
+    push(slot_us(1), 1.0f);
+}
+
+static bool near(float a, float b)
+{
+    return std::fabs(a - b) < 1e-3f;
+}
+
+static void check_steady()
+{
+    start_grid();
+    bool on_grid = true;
+    for (std::uint32_t n = 2; n < 20; ++n) {
+        const std::int32_t jitter = (n % 2 == 0) ? 1500 : -1500;
+        on_grid = on_grid && push(slot_us(n) + static_cast<std::uint32_t>(jitter), static_cast<float>(n)) == 1;
+    }
+    const TimingStats &s = timing_stats();
+    check(on_grid && g_emitted == 20 && s.resampled_samples == 0 && s.filled_samples == 0,
+          "jitter within bound passes through");
+    check(s.max_jitter_us == 1500 && s.dropped_samples == 0, "within-bound jitter: max_jitter, no drops");
+}
+
+static void check_missed_read()
+{
+    start_grid();
+    timing_note_read_failure();                  // slot 2 never read
+    const std::size_t n = push(slot_us(3), 3.0f);
+    push(slot_us(4), 4.0f);
+    const TimingStats &s = timing_stats();
+    check(n == 2 && g_emitted == 5 && near(g_out[2].ax, 2.0f) && near(g_out[3].ax, 3.0f),
+          "missed read: slot re-created by interpolation");
+    check(s.dropped_samples == 1 && s.filled_samples == 1, "missed read: dropped=1, filled=1");
+    check(s.max_jitter_us <= 1, "missed read is not counted as jitter");
+}
+
+static void check_early_jitter()
+{
+    start_grid();
+    const std::size_t early = push(slot_us(2) - 4000, 2.0f);  // before its slot
+    const std::size_t next  = push(slot_us(3), 3.0f);
+    const TimingStats &s = timing_stats();
+    check(early == 0 && next == 2 && g_emitted == 4, "early sample: slot interpolated with the next one");
+    check(s.dropped_samples == 0 && s.filled_samples == 1 && s.resampled_samples == 2,
+          "early sample: dropped=0, filled=1, resampled=2");
+    check(s.max_jitter_us == 4000, "early sample: max_jitter=4000 us");
+}
+
+static void check_late_jitter()
+{
+    start_grid();
+    const std::size_t late = push(slot_us(2) + 4000, 2.0f);   // after its slot
+    const std::size_t next = push(slot_us(3), 3.0f);
+    const TimingStats &s = timing_stats();
+    const float w = static_cast<float>(slot_us(2) - slot_us(1)) /
+                    static_cast<float>(slot_us(2) + 4000 - slot_us(1));
+    check(late == 1 && next == 1 && g_emitted == 4 && near(g_out[2].ax, 1.0f + w),
+          "late sample: moved back onto its slot");
+    check(s.dropped_samples == 0 && s.filled_samples == 0 && s.resampled_samples == 1,
+          "late sample: dropped=0, filled=0, resampled=1");
+    check(s.max_jitter_us == 4000, "late sample: max_jitter=4000 us");
+}
+
+static void check_gap_over_limit()
+{
+    // Slots 2..6 missed: one burst can fill 3 of them plus the sample itself
+    start_grid();
+    const std::size_t n    = push(slot_us(7), 7.0f);
+    const std::size_t next = push(slot_us(8), 8.0f);
+    const TimingStats &s = timing_stats();
+    check(n == BURST && near(g_out[2].ax, 2.0f) && near(g_out[5].ax, 7.0f),
+          "gap over limit: burst ends with the sample");
+    check(s.dropped_samples == 2 && s.filled_samples == 3, "gap over limit: dropped=2, filled=3");
+    check(next == 1 && g_emitted == 7 && s.max_jitter_us <= 1, "grid restarts on the sample after the gap");
+
+    // Exactly BURST slots is still bridged in full
+    start_grid();
+    const std::size_t full = push(slot_us(5), 5.0f);
+    check(full == BURST && timing_stats().dropped_samples == 0 && timing_stats().filled_samples == 3,
+          "gap of one burst is bridged: dropped=0, filled=3");
+}
+
+// ------------------------------------------------------------
+// FIFO mode: overrun accounting
+// ------------------------------------------------------------
+
+// Sensor time after n sets at ACQ_ODR_HZ
+static std::uint32_t sets_us(std::uint32_t n)
+{
+    return GRID_T0_US + static_cast<std::uint32_t>(static_cast<double>(n) * 1000000.0 / ACQ_ODR_HZ + 0.5);
+}
+
+static void check_fifo()
+{
+    const std::size_t B = ACQ_FIFO_BATCH_SETS;
+
+    timing_reset();
+    timing_check_fifo(sets_us(0), B, 0);
+    std::size_t lost = timing_check_fifo(sets_us(B), B, B);
+    lost += timing_check_fifo(sets_us(2 * B), B, B);
+    check(lost == 0 && timing_stats().dropped_samples == 0, "FIFO: steady polls lose nothing");
+
+    // A poll that kept reading past its own level snapshot (drained > seen)
+    lost = timing_check_fifo(sets_us(2 * B + 4), 0, B + 4);
+    check(lost == 0 && timing_stats().dropped_samples == 0, "FIFO: drain beyond the snapshot is not a loss");
+
+    // Main loop stalls for 1000 sets: the FIFO saturates at its capacity
+    const std::uint32_t stall = 2 * B + 4 + 1000;
+    lost = timing_check_fifo(sets_us(stall), ACQ_FIFO_CAPACITY_SETS, 0);
+    // (the set count from the timestamp may truncate by one set; the
+    // fraction is carried into the next poll)
+    const std::size_t expect = 1000 - ACQ_FIFO_CAPACITY_SETS;
+    check(lost + 1 >= expect && lost <= expect, "FIFO stall: lost = produced - capacity");
+    check(timing_stats().dropped_samples ==
+              (lost + ACQ_OVERSAMPLE_FACTOR / 2) / ACQ_OVERSAMPLE_FACTOR,
+          "FIFO stall: lost sets counted as dropped samples");
+
+    // Recovery: drain the full FIFO, next poll is steady again
+    lost = timing_check_fifo(sets_us(stall + B), B, ACQ_FIFO_CAPACITY_SETS);
+    check(lost == 0, "FIFO: steady again after the stall is drained");
+}
+
+int main()
+{
+    check_steady();
+    check_missed_read();
+    check_early_jitter();
+    check_late_jitter();
+    check_gap_over_limit();
+    check_fifo();
+
+    if (g_failures > 0) {
+        std::printf("[TIM] %d check(s) FAILED\n", g_failures);
+        return 1;
+    }
+    std::printf("[TIM] all checks passed\n");
+    return 0;
+}